@@ -0,0 +1,379 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace inline_vector {
+    // inline_vector handle stored as a pointer plus SizeType size and capacity instead of three
+    // pointers, 16 bytes with the default uint32_t (vs 24) so more handles share a cache line.
+    // Capacity is limited to numeric_limits<SizeType>::max(). Like static_vector the hot accessors
+    // are implemented directly and everything else is forwarded to an inline_vector view.
+    template <typename T, typename SizeType = ::std::uint32_t,
+              typename ErrorPolicy = ::inline_vector::default_error_policy>
+    struct compact_inline_vector {
+        static_assert(::std::is_unsigned<SizeType>::value,
+                      "compact_inline_vector requires an unsigned SizeType");
+
+        using element_type           = T;
+        using value_type             = typename ::std::remove_cv<T>::type;
+        using const_reference        = const value_type &;
+        using size_type              = ::std::size_t;
+        using difference_type        = ::std::ptrdiff_t;
+        using pointer                = element_type *;
+        using const_pointer          = const element_type *;
+        using reference              = element_type &;
+        using iterator               = pointer;
+        using const_iterator         = const_pointer;
+        using reverse_iterator       = ::std::reverse_iterator<iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+        using stored_size_type       = SizeType;
+        using view_type              = ::inline_vector::inline_vector<T, false, ErrorPolicy>;
+        using error_policy           = ErrorPolicy;
+
+        pointer          _data = {}; // start of constructed range
+        stored_size_type _size = {}; // number of constructed elements
+        stored_size_type _cap  = {}; // number of slots in the entire range
+
+      private:
+        [[nodiscard]] view_type view() const noexcept {
+            return view_type{_data, _data + _size, _data + _cap};
+        }
+        // runs fn against a view of the storage and keeps the resulting size
+        template <typename Fn> decltype(auto) apply(Fn &&fn) {
+            view_type v = view();
+            struct sync {
+                view_type        &v;
+                stored_size_type &size;
+                ~sync() {
+                    size = static_cast<stored_size_type>(v.size());
+                }
+            } on_exit{v, _size};
+            return ::std::forward<Fn>(fn)(v);
+        }
+
+      public:
+        constexpr compact_inline_vector() noexcept = default;
+        constexpr compact_inline_vector(iterator data, iterator end, iterator cap) noexcept
+            : _data(data), _size(static_cast<stored_size_type>(end - data)),
+              _cap(static_cast<stored_size_type>(cap - data)) {
+            assert(static_cast<size_type>(cap - data) <= max_size() &&
+                   "compact_inline_vector capacity exceeds its size type");
+        };
+        explicit constexpr compact_inline_vector(const view_type &v) noexcept
+            : compact_inline_vector(v._data, v._end, v._cap){};
+
+        // DANGER DANGER...HIGH VOLTAGE (same as inline_vector)
+        compact_inline_vector(const compact_inline_vector &other) {
+            if (!other.empty())
+                this->operator=(other);
+        };
+        // moving takes the storage over (same as inline_vector)
+        constexpr compact_inline_vector(compact_inline_vector &&other) noexcept
+            : _data(::std::exchange(other._data, nullptr)), _size(::std::exchange(other._size, 0)),
+              _cap(::std::exchange(other._cap, 0)){};
+
+        // front
+        [[nodiscard]] constexpr reference front() {
+            assert(!empty());
+            return _data[0];
+        };
+        [[nodiscard]] constexpr const_reference front() const {
+            assert(!empty());
+            return _data[0];
+        };
+        // back's
+        [[nodiscard]] constexpr reference back() {
+            assert(!empty());
+            return _data[_size - 1];
+        };
+        [[nodiscard]] constexpr const_reference back() const {
+            assert(!empty());
+            return _data[_size - 1];
+        };
+        // data's
+        [[nodiscard]] constexpr T *data() noexcept {
+            return _data;
+        };
+        [[nodiscard]] constexpr const T *data() const noexcept {
+            return _data;
+        };
+        // begin's
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return _data;
+        };
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return _data;
+        };
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return _data;
+        };
+        // rbegin's
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept {
+            return reverse_iterator(end());
+        };
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        };
+        [[nodiscard]] constexpr const_reverse_iterator crbegin() const noexcept {
+            return const_reverse_iterator(end());
+        };
+        // end's
+        [[nodiscard]] constexpr iterator end() noexcept {
+            return _data + _size;
+        };
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return _data + _size;
+        };
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return _data + _size;
+        };
+        // rend's
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept {
+            return reverse_iterator(begin());
+        };
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        };
+        [[nodiscard]] constexpr const_reverse_iterator crend() const noexcept {
+            return const_reverse_iterator(begin());
+        };
+        // empty's
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _size == 0;
+        };
+        // full (non standard)
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _size >= _cap;
+        };
+
+        // size
+        constexpr size_type size() const noexcept {
+            return _size;
+        };
+        // capacity
+        constexpr size_type capacity() const noexcept {
+            return _cap;
+        };
+        // max_size (constant)
+        static constexpr size_type max_size() noexcept {
+            return (::std::numeric_limits<stored_size_type>::max)();
+        };
+        // spare_capacity (non-standard), the raw storage past the elements in bytes (as inline_vector),
+        // appended with commit_back (elements) or commit_back_bytes (bytes)
+        [[nodiscard]] ::std::span<::std::byte> spare_capacity() noexcept {
+            return view().spare_capacity();
+        };
+        constexpr void commit_back(size_type n) noexcept {
+            assert(n <= capacity() - size() &&
+                   "compact_inline_vector cannot commit more than its spare capacity");
+            _size += static_cast<stored_size_type>(n);
+        };
+        constexpr void commit_back_bytes(size_type bytes) noexcept {
+            assert(bytes % sizeof(element_type) == 0 && "compact_inline_vector commits a partial element");
+            commit_back(bytes / sizeof(element_type));
+        };
+
+        // assign's
+        void assign(size_type count, const T &value) {
+            apply([&](view_type &v) { v.assign(count, value); });
+        };
+        template <::std::input_iterator It1> void assign(It1 first, It1 last) {
+            apply([&](view_type &v) { v.assign(first, last); });
+        };
+        void assign(::std::initializer_list<T> ilist) {
+            assign(ilist.begin(), ilist.end());
+        };
+
+        // operator ='s
+        compact_inline_vector &operator=(const compact_inline_vector &other) {
+            if (this != &other) {
+                view_type rhs = other.view();
+                apply([&](view_type &v) { v = rhs; });
+            }
+            return *this;
+        };
+        constexpr compact_inline_vector &operator=(compact_inline_vector &&other) noexcept {
+            if (this != &other) {
+                _data = ::std::exchange(other._data, nullptr);
+                _size = ::std::exchange(other._size, 0);
+                _cap  = ::std::exchange(other._cap, 0);
+            }
+            return *this;
+        };
+        compact_inline_vector &operator=(::std::initializer_list<T> ilist) {
+            assign(ilist);
+            return *this;
+        };
+
+        // what release hands out and adopt takes over, sizes in elements (as inline_vector)
+        using storage = typename view_type::storage;
+        // release (non-standard), gives the storage and its elements up untouched, the handle is left
+        // without storage
+        [[nodiscard]] constexpr storage release() noexcept {
+            storage s{_data, _size, _cap};
+            _data = nullptr;
+            _size = _cap = 0;
+            return s;
+        };
+        // adopt (non-standard), takes over data with size constructed elements and room for cap, the
+        // current storage is forgotten (as inline_vector without an exit policy)
+        constexpr void adopt(pointer data, size_type size, size_type cap) noexcept {
+            assert(size <= cap && "compact_inline_vector adopts more elements than capacity");
+            assert(cap <= max_size() && "compact_inline_vector capacity exceeds its size type");
+            _data = data;
+            _size = static_cast<stored_size_type>(size);
+            _cap  = static_cast<stored_size_type>(cap);
+        };
+        constexpr void adopt(storage s) noexcept {
+            adopt(s.data, s.size, s.capacity);
+        };
+
+        // append's (non-standard)
+        void append(size_type count, const T &value) {
+            apply([&](view_type &v) { v.append(count, value); });
+        }
+        template <::std::input_iterator It1> void append(It1 first, It1 last) {
+            apply([&](view_type &v) { v.append(first, last); });
+        }
+
+        // emplace_back's
+        template <class... Args> reference emplace_back(Args &&...args) noexcept(ErrorPolicy::is_noexcept) {
+            if (!ErrorPolicy::checked || _size < _cap) [[likely]] {
+                return unchecked_emplace_back(::std::forward<Args>(args)...);
+            } else { // error?
+                return apply(
+                    [&](view_type &v) -> reference { return v.emplace_back(::std::forward<Args>(args)...); });
+            }
+        };
+        template <class... Args> constexpr reference unchecked_emplace_back(Args &&...args) {
+            iterator it = end();
+            ::new ((void *)it) T(::std::forward<Args>(args)...);
+            _size += 1;
+            return *it;
+        };
+
+        // emplace's
+        template <class... Args> iterator emplace(const_iterator pos, Args &&...args) {
+            return apply([&](view_type &v) { return v.emplace(pos, ::std::forward<Args>(args)...); });
+        };
+
+        // insert's
+        iterator insert(const_iterator pos, const T &value) {
+            return emplace(pos, value);
+        };
+        iterator insert(const_iterator pos, T &&value) {
+            return emplace(pos, ::std::move(value));
+        };
+        iterator insert(const_iterator pos, size_type count, const T &value) {
+            return apply([&](view_type &v) { return v.insert(pos, count, value); });
+        };
+        template <::std::input_iterator It1> iterator insert(const_iterator pos, It1 first, It1 last) {
+            return apply([&](view_type &v) { return v.insert(pos, first, last); });
+        };
+        iterator insert(const_iterator pos, ::std::initializer_list<T> ilist) {
+            return insert(pos, ilist.begin(), ilist.end());
+        };
+
+        // push_back's
+        void push_back(const T &value) noexcept(ErrorPolicy::is_noexcept) {
+            emplace_back(value);
+        }
+        void push_back(T &&value) noexcept(ErrorPolicy::is_noexcept) {
+            emplace_back(::std::move(value));
+        };
+        // shove_back's (unchecked_push_back)
+        void shove_back(const T &value) {
+            unchecked_emplace_back(value);
+        }
+        void shove_back(T &&value) {
+            unchecked_emplace_back(::std::move(value));
+        }
+
+        // pop_back's
+        void pop_back() noexcept(ErrorPolicy::is_noexcept) {
+            if (!ErrorPolicy::checked || _size) [[likely]] {
+                _size -= 1;
+                if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                    end()->~T(); // destroy the tailing value
+                }
+            } else {
+                apply([](view_type &v) { v.pop_back(); });
+            }
+        };
+
+        // erase's
+        iterator erase(const_iterator pos) {
+            return apply([&](view_type &v) { return v.erase(pos); });
+        }
+        iterator erase(const_iterator first, const_iterator last) {
+            return apply([&](view_type &v) { return v.erase(first, last); });
+        }
+        template <class Pred> size_type erase_if(Pred pred) {
+            return apply([&](view_type &v) { return v.erase_if(pred); });
+        }
+        template <class It1> size_type remove_indices(It1 first, It1 last) {
+            return apply([&](view_type &v) { return v.remove_indices(first, last); });
+        }
+        template <class Range> size_type remove_indices(const Range &indices) {
+            return apply([&](view_type &v) { return v.remove_indices(indices); });
+        }
+        iterator unordered_erase(const_iterator pos) {
+            return apply([&](view_type &v) { return v.unordered_erase(pos); });
+        }
+        iterator unordered_erase(const_iterator first, const_iterator last) {
+            return apply([&](view_type &v) { return v.unordered_erase(first, last); });
+        }
+        template <class Pred> size_type unordered_erase_if(Pred pred) {
+            return apply([&](view_type &v) { return v.unordered_erase_if(pred); });
+        }
+
+        constexpr void swap(compact_inline_vector &other) noexcept {
+            ::std::swap(_data, other._data);
+            ::std::swap(_size, other._size);
+            ::std::swap(_cap, other._cap);
+        }
+
+        //[]'s
+        [[nodiscard]] constexpr reference operator[](size_type pos) {
+            assert(pos < size());
+            return _data[pos];
+        };
+        [[nodiscard]] constexpr const_reference operator[](size_type pos) const {
+            assert(pos < size());
+            return _data[pos];
+        };
+
+        // DANGER
+        [[nodiscard]] size_t unchecked_reserve(size_type n) {
+            assert(n <= max_size() && "compact_inline_vector capacity exceeds its size type");
+            size_t m = ::std::max<size_t>(_cap, n);
+            _cap     = static_cast<stored_size_type>(m);
+            return m;
+        }
+
+        // resize's
+        void resize(size_type count) {
+            apply([&](view_type &v) { v.resize(count); });
+        };
+        void resize(size_type count, const T &value) {
+            apply([&](view_type &v) { v.resize(count, value); });
+        };
+        void resize_for_overwrite(size_type count) {
+            apply([&](view_type &v) { v.resize_for_overwrite(count); });
+        };
+        void truncate(size_type count) noexcept {
+            apply([&](view_type &v) { v.truncate(count); });
+        };
+
+        constexpr void clear() noexcept {
+            if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                ::inline_vector::details::destroy(begin(), end());
+            }
+            _size = 0;
+        };
+    };
+
+    static_assert(sizeof(compact_inline_vector<int>) == sizeof(void *) + 2 * sizeof(::std::uint32_t),
+                  "compact_inline_vector should be a pointer and two 32 bit counts");
+} // namespace inline_vector
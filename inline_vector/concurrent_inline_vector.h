@@ -0,0 +1,197 @@
+#pragma once
+#include "inline_vector.h"
+#include "spin_wait.h"
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <span>
+
+namespace inline_vector {
+    // append only vector over caller supplied storage that any number of threads can emplace_back into
+    // at once without a lock. A slot is claimed with one fetch_add on the reservation cursor (_end),
+    // constructed, then published: _size only ever covers constructed elements, so readers can use
+    // [data(), data() + size()) while producers are still appending. Publication happens in
+    // reservation order, a producer waits (spinning) for the producers that claimed earlier slots to
+    // finish constructing theirs, which is the time of one element construction. Batches can be
+    // claimed with reserve_back(n), constructed without further contention and then commit()ed.
+    // Element constructors must not throw (a slot that is never constructed could not be published),
+    // an exception from one terminates. Removal (clear) and view() need the producers to be quiescent.
+    template <typename T, typename ErrorPolicy = ::inline_vector::default_error_policy>
+    struct concurrent_inline_vector {
+        using element_type    = T;
+        using value_type      = typename ::std::remove_cv<T>::type;
+        using const_reference = const value_type &;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer         = element_type *;
+        using const_pointer   = const element_type *;
+        using reference       = element_type &;
+        using iterator        = pointer;
+        using const_iterator  = const_pointer;
+        using view_type       = ::inline_vector::inline_vector<T, false, ErrorPolicy>;
+        using error_policy    = ErrorPolicy;
+
+      private:
+        pointer   _data = {}; // start of the storage
+        size_type _cap  = {}; // number of slots in the storage
+        // reservation cursor, index past the last claimed slot (may run past _cap once full)
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<size_type> _end{0};
+        // number of constructed elements readers may see, always a prefix of the claimed slots
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<size_type> _size{0};
+
+        template <typename RetType>
+        INLINE_VECTOR_FORCEINLINE RetType
+        return_error(RetType ret, [[maybe_unused]] const char *err_msg,
+                     ::std::errc code = ::std::errc::not_enough_memory) noexcept(ErrorPolicy::is_noexcept) {
+            ErrorPolicy::on_error(code, err_msg);
+            return ret;
+        };
+
+        // claims n slots, the index of the first or npos when they don't all fit (the claim stays
+        // spent, later claims fail as well)
+        [[nodiscard]] size_type claim(size_type n) noexcept {
+            size_type first = _end.fetch_add(n, ::std::memory_order_relaxed);
+            if (ErrorPolicy::checked && (first > _cap || n > _cap - first)) [[unlikely]]
+                return ~size_type{0};
+            return first;
+        }
+        // makes [first, first + n) visible once every earlier claim is visible
+        void publish(size_type first, size_type n) noexcept {
+            if (_size.load(::std::memory_order_acquire) != first) [[unlikely]]
+                ::inline_vector::details::spin_until(
+                    [&]() noexcept { return _size.load(::std::memory_order_acquire) == first; });
+            _size.store(first + n, ::std::memory_order_release);
+        }
+
+      public:
+        constexpr concurrent_inline_vector() noexcept = default;
+        // [data, end) are already constructed elements, [end, cap) free slots
+        concurrent_inline_vector(iterator data, iterator end, iterator cap) noexcept
+            : _data(data), _cap(static_cast<size_type>(cap - data)), _end(static_cast<size_type>(end - data)),
+              _size(static_cast<size_type>(end - data)){};
+        explicit concurrent_inline_vector(const view_type &v) noexcept
+            : concurrent_inline_vector(v._data, v._end, v._cap){};
+        // the atomics pin it in place
+        concurrent_inline_vector(const concurrent_inline_vector &)            = delete;
+        concurrent_inline_vector &operator=(const concurrent_inline_vector &) = delete;
+
+        // emplace_back, safe from any number of threads at once, returns the new element or nullptr
+        // when the storage is full
+        template <class... Args> pointer emplace_back(Args &&...args) noexcept(ErrorPolicy::is_noexcept) {
+            size_type idx = claim(1);
+            if (idx == ~size_type{0}) [[unlikely]]
+                return return_error(pointer{}, "concurrent_inline_vector cannot allocate to insert elements");
+            pointer slot = _data + idx;
+            [&]() noexcept { ::new ((void *)slot) T(::std::forward<Args>(args)...); }();
+            publish(idx, 1);
+            return slot;
+        }
+        pointer push_back(const T &value) noexcept(ErrorPolicy::is_noexcept) {
+            return emplace_back(value);
+        }
+        pointer push_back(T &&value) noexcept(ErrorPolicy::is_noexcept) {
+            return emplace_back(::std::move(value));
+        }
+        // append (non-standard), claims all of [first, last) with a single fetch_add so the
+        // elements stay contiguous, all or nothing, returns the first new element or nullptr
+        template <::std::forward_iterator It>
+        pointer append(It first, It last) noexcept(ErrorPolicy::is_noexcept) {
+            size_type n = static_cast<size_type>(::std::distance(first, last));
+            if (n == 0)
+                return _data + claimed();
+            ::std::span<T> slots = reserve_back(n);
+            if (slots.empty()) [[unlikely]]
+                return nullptr;
+            [&]() noexcept {
+                for (pointer slot = slots.data(); first != last; ++first, ++slot)
+                    ::new ((void *)slot) T(*first);
+            }();
+            commit(slots);
+            return slots.data();
+        }
+
+        // reserve_back (non-standard), claims n uninitialized slots with a single fetch_add, an empty
+        // span when they don't all fit. The caller constructs every slot and then commits the span,
+        // a reservation that is never committed stalls all later ones.
+        [[nodiscard]] ::std::span<T> reserve_back(size_type n) noexcept(ErrorPolicy::is_noexcept) {
+            if (n == 0)
+                return {};
+            size_type idx = claim(n);
+            if (idx == ~size_type{0}) [[unlikely]]
+                return return_error(::std::span<T>{},
+                                    "concurrent_inline_vector cannot allocate space to insert");
+            return {_data + idx, n};
+        }
+        // commit (non-standard), publishes a span returned by reserve_back once its slots are
+        // constructed, waits for earlier reservations to be committed first
+        void commit(::std::span<T> slots) noexcept {
+            assert(slots.empty() || (slots.data() >= _data && slots.data() + slots.size() <= _data + _cap));
+            if (!slots.empty())
+                publish(static_cast<size_type>(slots.data() - _data), slots.size());
+        }
+
+        // readers, see the published prefix, safe while producers append
+        [[nodiscard]] size_type size() const noexcept {
+            return _size.load(::std::memory_order_acquire);
+        };
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        };
+        // full, no more claims can succeed
+        [[nodiscard]] bool full() const noexcept {
+            return _end.load(::std::memory_order_relaxed) >= _cap;
+        };
+        // claimed (non-standard), slots handed out so far, published or still being constructed
+        [[nodiscard]] size_type claimed() const noexcept {
+            return (::std::min)(_end.load(::std::memory_order_relaxed), _cap);
+        };
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return _cap;
+        };
+        [[nodiscard]] constexpr size_type max_size() const noexcept {
+            return _cap;
+        };
+        [[nodiscard]] constexpr pointer data() noexcept {
+            return _data;
+        };
+        [[nodiscard]] constexpr const_pointer data() const noexcept {
+            return _data;
+        };
+        [[nodiscard]] reference operator[](size_type pos) noexcept {
+            assert(pos < size() && "element is not published");
+            return _data[pos];
+        };
+        [[nodiscard]] const_reference operator[](size_type pos) const noexcept {
+            assert(pos < size() && "element is not published");
+            return _data[pos];
+        };
+        // begin / end, a snapshot of the published prefix
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return _data;
+        };
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return _data;
+        };
+        [[nodiscard]] iterator end() noexcept {
+            return _data + size();
+        };
+        [[nodiscard]] const_iterator end() const noexcept {
+            return _data + size();
+        };
+
+        // quiescent only (no producer running)
+
+        // view (non-standard), the published elements as an inline_vector over the same storage
+        [[nodiscard]] view_type view() const noexcept {
+            return view_type{_data, _data + size(), _data + _cap};
+        }
+        void clear() noexcept {
+            size_type n = size();
+            if constexpr (!::std::is_trivially_destructible<T>::value)
+                ::inline_vector::details::destroy(_data, _data + n);
+            _size.store(0, ::std::memory_order_relaxed);
+            _end.store(0, ::std::memory_order_release);
+        }
+    };
+} // namespace inline_vector
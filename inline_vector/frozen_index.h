@@ -0,0 +1,440 @@
+#pragma once
+#include "simd_search.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace inline_vector {
+    namespace details {
+        inline constexpr ::std::size_t cache_line = 64;
+
+        INLINE_VECTOR_FORCEINLINE void prefetch(::std::uintptr_t address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(reinterpret_cast<const void *>(address));
+#elif defined(INLINE_VECTOR_SIMD_X86)
+            _mm_prefetch(reinterpret_cast<const char *>(address), _MM_HINT_T0);
+#endif
+        }
+        constexpr ::std::size_t align_up(::std::size_t offset, ::std::size_t align) noexcept {
+            return (offset + align - 1) / align * align;
+        }
+
+        // keys the s-tree compares a whole 64 byte node of at once
+        template <typename T>
+        concept stree_key = simd_element<T> && (sizeof(T) == 4 || sizeof(T) == 8);
+        template <typename Compare, typename T>
+        concept natural_order =
+            ::std::is_same_v<Compare, ::std::less<T>> || ::std::is_same_v<Compare, ::std::less<>>;
+
+        template <typename T> inline constexpr ::std::size_t stree_node_keys = cache_line / sizeof(T);
+        // padding after the last key, compares greater or equal to every query but NaN
+        template <typename T> constexpr T stree_pad() noexcept {
+            if constexpr (::std::is_floating_point_v<T>)
+                return ::std::numeric_limits<T>::infinity();
+            else
+                return (::std::numeric_limits<T>::max)();
+        }
+
+        // s-tree descents, each returns the slot of the first key >= x or npos. Nodes are sorted so the
+        // keys < x form a prefix of the compare mask and its trailing ones count them.
+        inline constexpr ::std::size_t stree_npos = ~::std::size_t{0};
+
+        template <typename T>
+        ::std::size_t stree_descend_scalar(const T *keys, ::std::size_t blocks, T x) noexcept {
+            constexpr ::std::size_t node = stree_node_keys<T>;
+            ::std::size_t           slot = stree_npos;
+            for (::std::size_t k = 0; k < blocks;) {
+                const T      *keys_k = keys + k * node;
+                ::std::size_t i      = 0;
+                for (::std::size_t j = 0; j < node; j++)
+                    i += keys_k[j] < x;
+                slot = i < node ? k * node + i : slot;
+                k    = k * (node + 1) + i + 1;
+            }
+            return slot;
+        }
+
+#if defined(INLINE_VECTOR_SIMD_X86)
+        struct stree_sse2 {
+            // keys < x as a byte mask
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("sse2")
+            static uint32_t lt_mask(const T *p, __m128i x) noexcept {
+                __m128i v = _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+                if constexpr (::std::is_same_v<T, float>)
+                    return static_cast<uint32_t>(_mm_movemask_epi8(
+                        _mm_castps_si128(_mm_cmplt_ps(_mm_castsi128_ps(v), _mm_castsi128_ps(x)))));
+                else if constexpr (::std::is_same_v<T, double>)
+                    return static_cast<uint32_t>(_mm_movemask_epi8(
+                        _mm_castpd_si128(_mm_cmplt_pd(_mm_castsi128_pd(v), _mm_castsi128_pd(x)))));
+                else if constexpr (::std::is_signed_v<T>)
+                    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi32(x, v)));
+                else {
+                    const __m128i bias = _mm_set1_epi32(INT32_MIN);
+                    return static_cast<uint32_t>(
+                        _mm_movemask_epi8(_mm_cmpgt_epi32(_mm_xor_si128(x, bias), _mm_xor_si128(v, bias))));
+                }
+            }
+            template <typename T>
+            INLINE_VECTOR_TARGET("sse2")
+            static ::std::size_t descend(const T *keys, ::std::size_t blocks, T x) noexcept {
+                constexpr ::std::size_t node = stree_node_keys<T>;
+                const __m128i           xv   = sse2_kernels::set1(x);
+                ::std::size_t           slot = stree_npos;
+                for (::std::size_t k = 0; k < blocks;) {
+                    const T *keys_k = keys + k * node;
+                    uint64_t mask   = uint64_t{lt_mask(keys_k, xv)} |
+                                    uint64_t{lt_mask(keys_k + node / 4, xv)} << 16 |
+                                    uint64_t{lt_mask(keys_k + node / 2, xv)} << 32 |
+                                    uint64_t{lt_mask(keys_k + 3 * node / 4, xv)} << 48;
+                    ::std::size_t i = static_cast<::std::size_t>(::std::countr_one(mask)) / sizeof(T);
+                    slot            = i < node ? k * node + i : slot;
+                    k               = k * (node + 1) + i + 1;
+                }
+                return slot;
+            }
+        };
+
+        struct stree_avx2 {
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx2")
+            static uint32_t lt_mask(const T *p, __m256i x) noexcept {
+                __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+                if constexpr (::std::is_same_v<T, float>)
+                    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_castps_si256(
+                        _mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_castsi256_ps(x), _CMP_LT_OQ))));
+                else if constexpr (::std::is_same_v<T, double>)
+                    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_castpd_si256(
+                        _mm256_cmp_pd(_mm256_castsi256_pd(v), _mm256_castsi256_pd(x), _CMP_LT_OQ))));
+                else {
+                    if constexpr (::std::is_unsigned_v<T>) {
+                        const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(
+                            sizeof(T) == 4 ? 0x8000000080000000ull : 0x8000000000000000ull));
+                        x                  = _mm256_xor_si256(x, bias);
+                        v                  = _mm256_xor_si256(v, bias);
+                    }
+                    if constexpr (sizeof(T) == 4)
+                        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi32(x, v)));
+                    else
+                        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi64(x, v)));
+                }
+            }
+            template <typename T>
+            INLINE_VECTOR_TARGET("avx2")
+            static ::std::size_t descend(const T *keys, ::std::size_t blocks, T x) noexcept {
+                constexpr ::std::size_t node = stree_node_keys<T>;
+                const __m256i           xv   = avx2_kernels::set1(x);
+                ::std::size_t           slot = stree_npos;
+                for (::std::size_t k = 0; k < blocks;) {
+                    const T *keys_k = keys + k * node;
+                    uint64_t mask   = uint64_t{lt_mask(keys_k, xv)} |
+                                    uint64_t{lt_mask(keys_k + node / 2, xv)} << 32;
+                    ::std::size_t i = static_cast<::std::size_t>(::std::countr_one(mask)) / sizeof(T);
+                    slot            = i < node ? k * node + i : slot;
+                    k               = k * (node + 1) + i + 1;
+                }
+                return slot;
+            }
+        };
+
+        struct stree_avx512 {
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx512f,avx512bw")
+            static uint32_t lt_mask(const T *p, __m512i x) noexcept {
+                __m512i v = _mm512_load_si512(reinterpret_cast<const void *>(p));
+                if constexpr (::std::is_same_v<T, float>)
+                    return _mm512_cmp_ps_mask(_mm512_castsi512_ps(v), _mm512_castsi512_ps(x), _CMP_LT_OQ);
+                else if constexpr (::std::is_same_v<T, double>)
+                    return _mm512_cmp_pd_mask(_mm512_castsi512_pd(v), _mm512_castsi512_pd(x), _CMP_LT_OQ);
+                else if constexpr (sizeof(T) == 4)
+                    return ::std::is_signed_v<T> ? _mm512_cmplt_epi32_mask(v, x)
+                                                 : _mm512_cmplt_epu32_mask(v, x);
+                else
+                    return ::std::is_signed_v<T> ? _mm512_cmplt_epi64_mask(v, x)
+                                                 : _mm512_cmplt_epu64_mask(v, x);
+            }
+            template <typename T>
+            INLINE_VECTOR_TARGET("avx512f,avx512bw")
+            static ::std::size_t descend(const T *keys, ::std::size_t blocks, T x) noexcept {
+                constexpr ::std::size_t node = stree_node_keys<T>;
+                const __m512i           xv   = avx512_kernels::set1(x);
+                ::std::size_t           slot = stree_npos;
+                for (::std::size_t k = 0; k < blocks;) {
+                    ::std::size_t i =
+                        static_cast<::std::size_t>(::std::countr_one(lt_mask(keys + k * node, xv)));
+                    slot            = i < node ? k * node + i : slot;
+                    k               = k * (node + 1) + i + 1;
+                }
+                return slot;
+            }
+        };
+#endif
+
+        template <stree_key T>
+        ::std::size_t stree_descend(const T *keys, ::std::size_t blocks, T x) noexcept {
+#if defined(INLINE_VECTOR_SIMD_X86)
+            switch (active_simd_level().load(::std::memory_order_relaxed)) {
+            case simd_level::avx512:
+                return stree_avx512::descend(keys, blocks, x);
+            case simd_level::avx2:
+                return stree_avx2::descend(keys, blocks, x);
+            case simd_level::sse2:
+                if constexpr (::std::is_floating_point_v<T> || sizeof(T) == 4) // no 64 bit integer compare
+                    return stree_sse2::descend(keys, blocks, x);
+                [[fallthrough]];
+            default:
+                break;
+            }
+#endif
+            return stree_descend_scalar(keys, blocks, x);
+        }
+    }; // namespace details
+
+    // read only search index over a copy of sorted keys in Eytzinger (breadth first) order, built once
+    // with freeze() into a caller supplied buffer. The descent is branchless and prefetches the cache
+    // line holding the node's descendants 4 (32 bit keys) levels down, so the misses of a lookup
+    // overlap instead of forming a chain. Lookups return indices into the original sorted keys. The
+    // index is a view, the buffer must outlive it.
+    template <typename K, typename Compare = ::std::less<K>,
+              typename ErrorPolicy = ::inline_vector::default_error_policy>
+    struct eytzinger_index {
+        static_assert(::std::is_trivially_copyable_v<K> && ::std::is_trivially_destructible_v<K>,
+                      "frozen indexes copy keys into raw storage and never destroy them");
+        using key_type    = K;
+        using key_compare = Compare;
+        using size_type   = ::std::size_t;
+
+      private:
+        // nodes are 1 based with slot 0 unused, so the descendants k * line_keys + [0, line_keys) of
+        // node k fill exactly one aligned cache line
+        static constexpr size_type line_keys =
+            (::std::max)(::inline_vector::details::cache_line / sizeof(K), ::std::size_t{1});
+
+        const K                          *_keys  = nullptr;
+        const size_type                  *_ranks = nullptr;
+        size_type                         _size  = 0;
+        [[no_unique_address]] key_compare _comp;
+
+        static constexpr size_type ranks_offset(size_type n) noexcept {
+            return ::inline_vector::details::align_up((n + 1) * sizeof(K), alignof(size_type));
+        }
+        // node of the first key !(key < x) (Upper: x < key), 0 when there is none
+        template <bool Upper, typename Key> [[nodiscard]] size_type descend(const Key &x) const {
+            const ::std::uintptr_t base = reinterpret_cast<::std::uintptr_t>(_keys);
+            size_type              k    = 1;
+            while (k <= _size) {
+                ::inline_vector::details::prefetch(base + k * line_keys * sizeof(K));
+                if constexpr (Upper)
+                    k = 2 * k + !_comp(x, _keys[k]);
+                else
+                    k = 2 * k + _comp(_keys[k], x);
+            }
+            // undo the right turns taken after the answer, then the left turn into it
+            return k >> (::std::countr_one(k) + 1);
+        }
+
+      public:
+        constexpr eytzinger_index() noexcept = default;
+        // lays out the sorted keys [sorted, sorted + n) into buffer, an empty index (and an error
+        // through ErrorPolicy) when bytes < bytes_for(n)
+        eytzinger_index(const K *sorted, size_type n, void *buffer, size_type bytes,
+                        const key_compare &comp = {}) noexcept(ErrorPolicy::is_noexcept)
+            : _comp(comp) {
+            assert(::std::is_sorted(sorted, sorted + n, _comp) && "freeze requires sorted keys");
+            ::std::uintptr_t base = reinterpret_cast<::std::uintptr_t>(buffer);
+            size_type        skew =
+                ::inline_vector::details::align_up(base, ::inline_vector::details::cache_line) - base;
+            if (bytes < skew || bytes - skew < ranks_offset(n) + (n + 1) * sizeof(size_type)) {
+                ErrorPolicy::on_error(::std::errc::not_enough_memory, "frozen index buffer is too small");
+                return;
+            }
+            K         *keys  = reinterpret_cast<K *>(base + skew);
+            size_type *ranks = reinterpret_cast<size_type *>(base + skew + ranks_offset(n));
+            // in order walk of the implicit tree hands out the sorted keys
+            size_type  next  = 0;
+            auto       build = [&](auto &self, size_type k) -> void {
+                if (k > n)
+                    return;
+                self(self, 2 * k);
+                ::new ((void *)(keys + k)) K(sorted[next]);
+                ::new ((void *)(ranks + k)) size_type(next);
+                next += 1;
+                self(self, 2 * k + 1);
+            };
+            build(build, 1);
+            _keys  = keys;
+            _ranks = ranks;
+            _size  = n;
+        }
+
+        // bytes a buffer needs to hold the index of n keys at any alignment
+        [[nodiscard]] static constexpr size_type bytes_for(size_type n) noexcept {
+            return ranks_offset(n) + (n + 1) * sizeof(size_type) + ::inline_vector::details::cache_line - 1;
+        }
+
+        [[nodiscard]] constexpr size_type size() const noexcept {
+            return _size;
+        }
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _size == 0;
+        }
+        [[nodiscard]] constexpr key_compare key_comp() const {
+            return _comp;
+        }
+
+        // lookups, indices into the sorted keys, size() when there is none. Key can be any type
+        // Compare accepts against K.
+        template <typename Key = K> [[nodiscard]] size_type lower_bound(const Key &x) const {
+            size_type k = descend<false>(x);
+            return k ? _ranks[k] : _size;
+        }
+        template <typename Key = K> [[nodiscard]] size_type upper_bound(const Key &x) const {
+            size_type k = descend<true>(x);
+            return k ? _ranks[k] : _size;
+        }
+        // index of the first key equivalent to x
+        template <typename Key = K> [[nodiscard]] size_type find(const Key &x) const {
+            size_type k = descend<false>(x);
+            return k && !_comp(x, _keys[k]) ? _ranks[k] : _size;
+        }
+        template <typename Key = K> [[nodiscard]] bool contains(const Key &x) const {
+            size_type k = descend<false>(x);
+            return k && !_comp(x, _keys[k]);
+        }
+    };
+
+    // read only search index over a copy of sorted arithmetic keys as an implicit static B-tree
+    // (s-tree): 64 byte nodes of 16 (32 bit) or 8 (64 bit) keys, each compared against the query in
+    // one or a few vector compares, with children at k * (keys + 1) + i + 1. A lookup touches one
+    // cache line per level of a tree that is 4 (3) times shallower than a binary one. The sse2, avx2 or
+    // avx-512 descent is picked at runtime like simd_search.h. Lookups return indices into the original
+    // sorted keys, the index is a view over a caller supplied buffer that must outlive it.
+    template <::inline_vector::details::stree_key K,
+              typename ErrorPolicy = ::inline_vector::default_error_policy>
+    struct stree_index {
+        using key_type    = K;
+        using key_compare = ::std::less<K>;
+        using size_type   = ::std::size_t;
+
+        static constexpr size_type node_keys = ::inline_vector::details::stree_node_keys<K>;
+
+      private:
+        const K         *_keys   = nullptr;
+        const size_type *_ranks  = nullptr;
+        size_type        _size   = 0;
+        size_type        _blocks = 0;
+
+        static constexpr size_type blocks_for(size_type n) noexcept {
+            return (n + node_keys - 1) / node_keys;
+        }
+        [[nodiscard]] size_type descend(K x) const noexcept {
+            return _blocks ? ::inline_vector::details::stree_descend(_keys, _blocks, x)
+                           : ::inline_vector::details::stree_npos;
+        }
+
+      public:
+        constexpr stree_index() noexcept = default;
+        // lays out the sorted keys [sorted, sorted + n) into buffer, an empty index (and an error
+        // through ErrorPolicy) when bytes < bytes_for(n)
+        stree_index(const K *sorted, size_type n, void *buffer, size_type bytes,
+                    const key_compare & = {}) noexcept(ErrorPolicy::is_noexcept) {
+            assert(::std::is_sorted(sorted, sorted + n) && "freeze requires sorted keys");
+            const size_type  blocks = blocks_for(n);
+            ::std::uintptr_t base   = reinterpret_cast<::std::uintptr_t>(buffer);
+            size_type        skew =
+                ::inline_vector::details::align_up(base, ::inline_vector::details::cache_line) - base;
+            if (bytes < skew || bytes - skew < bytes_for(n) - (::inline_vector::details::cache_line - 1)) {
+                ErrorPolicy::on_error(::std::errc::not_enough_memory, "frozen index buffer is too small");
+                return;
+            }
+            K         *keys  = reinterpret_cast<K *>(base + skew);
+            size_type *ranks = reinterpret_cast<size_type *>(base + skew + blocks * node_keys * sizeof(K));
+            // in order walk of the implicit tree, slots past the last key are padded with a key no
+            // query is greater than and rank n
+            size_type  next  = 0;
+            auto       build = [&](auto &self, size_type k) -> void {
+                if (k >= blocks)
+                    return;
+                for (size_type i = 0; i < node_keys; i++) {
+                    self(self, k * (node_keys + 1) + i + 1);
+                    const bool real = next < n;
+                    ::new ((void *)(keys + k * node_keys + i))
+                        K(real ? sorted[next] : ::inline_vector::details::stree_pad<K>());
+                    ::new ((void *)(ranks + k * node_keys + i)) size_type(next);
+                    next += real;
+                }
+                self(self, k * (node_keys + 1) + node_keys + 1);
+            };
+            build(build, 0);
+            _keys   = keys;
+            _ranks  = ranks;
+            _size   = n;
+            _blocks = blocks;
+        }
+
+        // bytes a buffer needs to hold the index of n keys at any alignment
+        [[nodiscard]] static constexpr size_type bytes_for(size_type n) noexcept {
+            return blocks_for(n) * node_keys * (sizeof(K) + sizeof(size_type)) +
+                   ::inline_vector::details::cache_line - 1;
+        }
+
+        [[nodiscard]] constexpr size_type size() const noexcept {
+            return _size;
+        }
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _size == 0;
+        }
+        [[nodiscard]] constexpr key_compare key_comp() const {
+            return {};
+        }
+
+        // lookups, indices into the sorted keys, size() when there is none
+        [[nodiscard]] size_type lower_bound(K x) const noexcept {
+            size_type slot = descend(x);
+            return slot != ::inline_vector::details::stree_npos ? _ranks[slot] : _size;
+        }
+        // index of the first key equal to x
+        [[nodiscard]] size_type find(K x) const noexcept {
+            size_type slot = descend(x);
+            return slot != ::inline_vector::details::stree_npos && _ranks[slot] != _size && !(x < _keys[slot])
+                       ? _ranks[slot]
+                       : _size;
+        }
+        [[nodiscard]] bool contains(K x) const noexcept {
+            return find(x) != _size;
+        }
+    };
+
+    namespace details {
+        template <typename K, typename Compare, typename ErrorPolicy,
+                  bool = stree_key<K> && natural_order<Compare, K>>
+        struct frozen_layout {
+            using type = ::inline_vector::eytzinger_index<K, Compare, ErrorPolicy>;
+        };
+        template <typename K, typename Compare, typename ErrorPolicy>
+        struct frozen_layout<K, Compare, ErrorPolicy, true> {
+            using type = ::inline_vector::stree_index<K, ErrorPolicy>;
+        };
+    }; // namespace details
+
+    // the s-tree for arithmetic keys in their natural order, Eytzinger for everything else
+    template <typename K, typename Compare = ::std::less<K>,
+              typename ErrorPolicy = ::inline_vector::default_error_policy>
+    using frozen_index = typename ::inline_vector::details::frozen_layout<K, Compare, ErrorPolicy>::type;
+
+    // freeze, builds the read only index of a sorted vector into buffer (see frozen_index::bytes_for),
+    // the vector itself is left untouched and lookups return indices into it
+    template <typename ErrorPolicy = ::inline_vector::default_error_policy,
+              ::inline_vector::simd::contiguous_vector Vec,
+              typename Compare = ::std::less<::inline_vector::simd::value_of<Vec>>>
+    [[nodiscard]] frozen_index<::inline_vector::simd::value_of<Vec>, Compare, ErrorPolicy>
+    freeze(const Vec &sorted, void *buffer, ::std::size_t bytes, const Compare &comp = {}) {
+        using index = frozen_index<::inline_vector::simd::value_of<Vec>, Compare, ErrorPolicy>;
+        return index(sorted.data(), sorted.size(), buffer, bytes, comp);
+    }
+} // namespace inline_vector
@@ -0,0 +1,172 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace inline_vector {
+    // bump allocator over one block that hands out inline_vectors (handle and storage both live in the
+    // block), released all at once by rewinding to a checkpoint. A vector costs one pointer bump, a
+    // rewind one pointer store, plus a walk over the vectors made since the checkpoint that asked
+    // for their elements to be destroyed: destroy_elements (destruct_on_exit == true) vectors of non
+    // trivially destructible T. Everything else (trivial T, or skip_destruction) is never visited, its
+    // elements are simply forgotten with the bytes under them.
+    // The block is either borrowed from the caller or owned (allocated once at construction).
+    struct inline_arena {
+        using size_type = ::std::size_t;
+
+        // alignment of an owned block
+        static constexpr size_type block_alignment = 64;
+
+      private:
+        // vectors whose elements a rewind destroys, newest first
+        struct record {
+            void (*destroy)(record *) noexcept;
+            record *prev;
+        };
+        template <typename Vec> struct tracked {
+            record rec; // first, so a record * is the tracked *
+            Vec    vec;
+
+            static void destroy(record *r) noexcept {
+                reinterpret_cast<tracked *>(r)->vec.~Vec();
+            }
+        };
+
+        unsigned char *_begin = nullptr;
+        unsigned char *_top   = nullptr; // next free byte
+        unsigned char *_end   = nullptr;
+        record        *_last  = nullptr; // newest tracked vector
+        bool           _owned = false;
+
+        template <typename RetType, typename ErrorPolicy>
+        INLINE_VECTOR_FORCEINLINE static RetType
+        return_error(RetType ret, [[maybe_unused]] const char *err_msg,
+                     ::std::errc code = ::std::errc::not_enough_memory) noexcept(ErrorPolicy::is_noexcept) {
+            ErrorPolicy::on_error(code, err_msg);
+            return ret;
+        };
+
+        // carves n objects of T at align, nullptr when they don't fit
+        template <typename T> [[nodiscard]] T *carve(size_type n, size_type align) noexcept {
+            ::std::uintptr_t top  = reinterpret_cast<::std::uintptr_t>(_top);
+            size_type        skew = (align - top % align) % align;
+            size_type        room = static_cast<size_type>(_end - _top);
+            if (skew > room || n > (room - skew) / sizeof(T)) [[unlikely]]
+                return nullptr;
+            _top = _top + skew + n * sizeof(T);
+            return reinterpret_cast<T *>(top + skew);
+        }
+
+      public:
+        // where to rewind to, from mark()
+        struct marker {
+            unsigned char *top  = nullptr;
+            record        *last = nullptr;
+        };
+        // checkpoint, rewinds the arena when it goes out of scope
+        struct scope {
+            inline_arena *arena = nullptr;
+            marker        mark  = {};
+
+            explicit scope(inline_arena &a) noexcept : arena(&a), mark(a.mark()){};
+            scope(scope &&other) noexcept : arena(::std::exchange(other.arena, nullptr)), mark(other.mark){};
+            scope(const scope &)            = delete;
+            scope &operator=(const scope &) = delete;
+            scope &operator=(scope &&)      = delete;
+            ~scope() {
+                if (arena)
+                    arena->rewind(mark);
+            }
+            // rewind early, the scope stays armed for what is made after
+            void rewind() noexcept {
+                if (arena)
+                    arena->rewind(mark);
+            }
+        };
+
+        constexpr inline_arena() noexcept = default;
+        // borrows [buffer, buffer + bytes)
+        inline_arena(void *buffer, size_type bytes) noexcept
+            : _begin(static_cast<unsigned char *>(buffer)), _top(_begin), _end(_begin + bytes){};
+        // owns a block of bytes, empty (capacity() == 0) when it cannot be allocated
+        explicit inline_arena(size_type bytes) noexcept
+            : _begin(static_cast<unsigned char *>(
+                  ::operator new(bytes, ::std::align_val_t{block_alignment}, ::std::nothrow))),
+              _top(_begin), _end(_begin ? _begin + bytes : nullptr), _owned(_begin != nullptr){};
+        inline_arena(const inline_arena &)            = delete;
+        inline_arena &operator=(const inline_arena &) = delete;
+        ~inline_arena() {
+            reset();
+            if (_owned)
+                ::operator delete(_begin, ::std::align_val_t{block_alignment});
+        }
+
+        // make_vector, an empty inline_vector with room for cap elements, storage aligned to
+        // align (at least alignof(T)). The vector lives in the arena until a rewind past it, nullptr
+        // (through ErrorPolicy) when the arena is out of room.
+        template <typename T, auto destruct_on_exit = false,
+                  typename ErrorPolicy = ::inline_vector::default_error_policy>
+        [[nodiscard]] ::inline_vector::inline_vector<T, destruct_on_exit, ErrorPolicy> *
+        make_vector(size_type cap, size_type align = alignof(T)) noexcept(ErrorPolicy::is_noexcept) {
+            using vector_type = ::inline_vector::inline_vector<T, destruct_on_exit, ErrorPolicy>;
+            static_assert(!vector_type::exit_policy::releases, "inline_arena storage goes back by rewinding");
+            constexpr bool track = !::std::is_trivially_destructible<vector_type>::value;
+            using handle_type = typename ::std::conditional<track, tracked<vector_type>, vector_type>::type;
+
+            unsigned char *before = _top;
+            handle_type   *handle = carve<handle_type>(1, alignof(handle_type));
+            T             *data   = handle ? carve<T>(cap, (::std::max)(align, alignof(T))) : nullptr;
+            if (data == nullptr) [[unlikely]] {
+                _top = before;
+                return return_error<vector_type *, ErrorPolicy>(nullptr,
+                                                                "inline_arena cannot allocate a vector");
+            }
+            if constexpr (track) {
+                ::new ((void *)handle) handle_type{{&handle_type::destroy, _last}, {data, data, data + cap}};
+                _last = &handle->rec;
+                return &handle->vec;
+            } else {
+                return ::new ((void *)handle) vector_type{data, data, data + cap};
+            }
+        }
+        // allocate (non-standard), raw bytes at align, nullptr when the arena is out of room
+        [[nodiscard]] void *allocate(size_type bytes,
+                                     size_type align = alignof(::std::max_align_t)) noexcept {
+            return carve<unsigned char>(bytes, align);
+        }
+
+        // checkpoint, everything made after it is released when the returned scope ends
+        [[nodiscard]] scope checkpoint() noexcept {
+            return scope(*this);
+        }
+        [[nodiscard]] marker mark() const noexcept {
+            return marker{_top, _last};
+        }
+        // rewind, destroys the elements of the tracked vectors made after m (newest first) and hands
+        // their bytes back, vectors made after m must not be used any more
+        void rewind(marker m) noexcept {
+            assert(m.top >= _begin && m.top <= _top && "rewind to a marker that is not in this arena");
+            for (; _last != m.last; _last = _last->prev)
+                _last->destroy(_last);
+            _top = m.top;
+        }
+        // reset, rewinds everything
+        void reset() noexcept {
+            rewind(marker{_begin, nullptr});
+        }
+
+        [[nodiscard]] size_type used() const noexcept {
+            return static_cast<size_type>(_top - _begin);
+        }
+        [[nodiscard]] size_type remaining() const noexcept {
+            return static_cast<size_type>(_end - _top);
+        }
+        [[nodiscard]] size_type capacity() const noexcept {
+            return static_cast<size_type>(_end - _begin);
+        }
+    };
+} // namespace inline_vector
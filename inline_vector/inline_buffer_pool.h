@@ -0,0 +1,206 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace inline_vector {
+    // process wide recycler of vector storage. Buffers come in power of two capacity classes (64 bytes
+    // to 64 MiB, 64 byte aligned) and are kept on intrusive freelists, one set per thread so the
+    // common acquire / release is a few loads and stores with no lock and no malloc. A thread keeps
+    // at most thread_cache_limit buffers per class, further releases (typically buffers acquired on
+    // another thread) go to a shared set of lists under a mutex, which threads fall back to when
+    // their own list is empty, and a thread hands its whole cache to the shared lists when it exits.
+    // Larger requests go straight to the system (counted as misses).
+    // acquire hands out an empty inline_vector with all of its class as capacity, release destroys
+    // what is left in it and takes the storage back (or the vector does so itself with the owner
+    // exit policy).
+    struct inline_buffer_pool {
+        using size_type = ::std::size_t;
+
+        static constexpr size_type alignment          = 64;
+        static constexpr size_type min_class_bytes    = 64;
+        static constexpr unsigned  classes            = 21; // up to min_class_bytes << 20, 64 MiB
+        static constexpr unsigned  thread_cache_limit = 16; // buffers per class and thread
+
+        // counters of the calling thread
+        struct stats {
+            size_type hits        = 0; // acquires served from the thread's own lists
+            size_type shared_hits = 0; // acquires served from the shared lists
+            size_type misses      = 0; // acquires that went to the system
+            size_type releases    = 0;
+        };
+
+      private:
+        struct node {
+            node *next;
+        };
+        struct freelist {
+            node    *head  = nullptr;
+            unsigned count = 0;
+        };
+        struct shared_lists {
+            ::std::mutex lock;
+            node        *head[classes] = {};
+        };
+        struct thread_cache {
+            freelist lists[classes];
+            stats    counters;
+
+            thread_cache() noexcept = default;
+            thread_cache(const thread_cache &) = delete;
+            ~thread_cache() {
+                shared_lists               &s = shared();
+                ::std::lock_guard<::std::mutex> hold(s.lock);
+                for (unsigned c = 0; c < classes; c++)
+                    while (node *n = lists[c].head) {
+                        lists[c].head = n->next;
+                        n->next       = s.head[c];
+                        s.head[c]     = n;
+                    }
+            }
+        };
+
+        // never destroyed, threads may exit (and flush into it) after static destructors have run
+        [[nodiscard]] static shared_lists &shared() noexcept {
+            static shared_lists *lists = new shared_lists;
+            return *lists;
+        }
+        [[nodiscard]] static thread_cache &local() noexcept {
+            static thread_local thread_cache cache;
+            return cache;
+        }
+        // class c holds min_class_bytes << c bytes
+        [[nodiscard]] static constexpr unsigned class_of(size_type bytes) noexcept {
+            constexpr unsigned min_width = static_cast<unsigned>(::std::bit_width(min_class_bytes - 1));
+            if (bytes <= min_class_bytes)
+                return 0;
+            return static_cast<unsigned>(::std::bit_width(bytes - 1)) - min_width;
+        }
+        [[nodiscard]] static constexpr size_type class_bytes(unsigned c) noexcept {
+            return min_class_bytes << c;
+        }
+
+        [[nodiscard]] static void *take(unsigned c) noexcept {
+            thread_cache &cache = local();
+            if (c < classes) {
+                freelist &own = cache.lists[c];
+                if (node *n = own.head) [[likely]] {
+                    own.head = n->next;
+                    own.count -= 1;
+                    cache.counters.hits += 1;
+                    return n;
+                }
+                // refill up to half a cache from the shared list, one lock for the lot
+                shared_lists               &s = shared();
+                ::std::lock_guard<::std::mutex> hold(s.lock);
+                if (node *n = s.head[c]) {
+                    s.head[c] = n->next;
+                    for (; s.head[c] && own.count < thread_cache_limit / 2; own.count++) {
+                        node *extra = s.head[c];
+                        s.head[c]   = extra->next;
+                        extra->next = own.head;
+                        own.head    = extra;
+                    }
+                    cache.counters.shared_hits += 1;
+                    return n;
+                }
+            }
+            cache.counters.misses += 1;
+            return ::operator new(class_bytes(c), ::std::align_val_t{alignment}, ::std::nothrow);
+        }
+        static void give(unsigned c, void *buffer) noexcept {
+            thread_cache &cache = local();
+            cache.counters.releases += 1;
+            if (c >= classes) {
+                ::operator delete(buffer, ::std::align_val_t{alignment});
+                return;
+            }
+            node     *n   = static_cast<node *>(buffer);
+            freelist &own = cache.lists[c];
+            if (own.count < thread_cache_limit) [[likely]] {
+                n->next  = own.head;
+                own.head = n;
+                own.count += 1;
+                return;
+            }
+            shared_lists               &s = shared();
+            ::std::lock_guard<::std::mutex> hold(s.lock);
+            n->next   = s.head[c];
+            s.head[c] = n;
+        }
+        // bytes a vector of cap T needs, at least two elements so that the capacity a class gives
+        // (class_bytes / sizeof(T), rounded down) maps back to the same class on release
+        [[nodiscard]] static constexpr size_type bytes_for(size_type cap, size_type size) noexcept {
+            return (::std::max)(cap, size_type{2}) * size;
+        }
+
+      public:
+        // exit policy of vectors that give their storage back to the pool by themselves when they go
+        // out of scope, acquire<T, inline_buffer_pool::owner{}>(cap)
+        struct owner {
+            static constexpr const bool destroys = true;
+            static constexpr const bool releases = true;
+            template <typename T> static void release(T *data, size_type capacity) noexcept {
+                give(class_of(bytes_for(capacity, sizeof(T))), data);
+            }
+        };
+
+        // acquire, an empty inline_vector with room for at least cap elements, an empty vector
+        // without storage (through ErrorPolicy) when the system is out of memory
+        template <typename T, auto destruct_on_exit = false,
+                  typename ErrorPolicy = ::inline_vector::default_error_policy>
+        [[nodiscard]] static ::inline_vector::inline_vector<T, destruct_on_exit, ErrorPolicy>
+        acquire(size_type cap) noexcept(ErrorPolicy::is_noexcept) {
+            static_assert(alignof(T) <= alignment, "inline_buffer_pool buffers are 64 byte aligned");
+            using vector_type = ::inline_vector::inline_vector<T, destruct_on_exit, ErrorPolicy>;
+            unsigned c        = classes;
+            void    *buffer   = nullptr;
+            if (cap <= (::std::numeric_limits<size_type>::max)() / 4 / sizeof(T)) [[likely]] {
+                c      = class_of(bytes_for(cap, sizeof(T)));
+                buffer = take(c);
+            }
+            if (buffer == nullptr) [[unlikely]] {
+                ErrorPolicy::on_error(::std::errc::not_enough_memory, "inline_buffer_pool cannot allocate");
+                return vector_type{};
+            }
+            T *data = static_cast<T *>(buffer);
+            return vector_type{data, data, data + class_bytes(c) / sizeof(T)};
+        }
+        // release, destroys the elements of v and takes its storage back, v is left without storage.
+        // v must come from acquire (on any thread).
+        template <typename T, auto destruct_on_exit, typename ErrorPolicy>
+        static void release(::inline_vector::inline_vector<T, destruct_on_exit, ErrorPolicy> &v) noexcept {
+            if (v._data == nullptr)
+                return;
+            v.clear();
+            unsigned c = class_of(bytes_for(v.capacity(), sizeof(T)));
+            give(c, v.release().data);
+        }
+
+        [[nodiscard]] static stats thread_stats() noexcept {
+            return local().counters;
+        }
+        // trim, hands the calling thread's cached buffers and the shared ones back to the system
+        static void trim() noexcept {
+            auto drain = [](node *&head) noexcept {
+                while (node *n = head) {
+                    head = n->next;
+                    ::operator delete(n, ::std::align_val_t{alignment});
+                }
+            };
+            thread_cache &cache = local();
+            for (freelist &own : cache.lists) {
+                drain(own.head);
+                own.count = 0;
+            }
+            shared_lists               &s = shared();
+            ::std::lock_guard<::std::mutex> hold(s.lock);
+            for (node *&head : s.head)
+                drain(head);
+        }
+    };
+} // namespace inline_vector
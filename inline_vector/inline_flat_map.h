@@ -0,0 +1,476 @@
+#pragma once
+#include "inline_flat_set.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <utility>
+
+namespace inline_vector {
+    // sorted unique keys with their values in a separate column, both on caller supplied storage,
+    // so lookups only stream the keys. Lookups are branchless binary searches and heterogeneous
+    // when Compare is transparent, capacity errors go through ErrorPolicy like inline_vector.
+    template <typename K, typename V, typename Compare = ::std::less<K>,
+              typename ErrorPolicy = ::inline_vector::default_error_policy>
+    struct inline_flat_map {
+        using key_type        = K;
+        using mapped_type     = V;
+        using value_type      = ::std::pair<K, V>;
+        using key_compare     = Compare;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+        using reference       = ::std::pair<const K &, V &>;
+        using const_reference = ::std::pair<const K &, const V &>;
+        using key_view_type   = ::inline_vector::inline_vector<K, false, ErrorPolicy>;
+        using value_view_type = ::inline_vector::inline_vector<V, false, ErrorPolicy>;
+        using error_policy    = ErrorPolicy;
+
+        // walks both columns in step, dereferences to a pair of references (a proxy, so the legacy
+        // category is input)
+        template <bool Const> struct zip_iterator {
+            using mapped_pointer    = ::std::conditional_t<Const, const V *, V *>;
+            using value_type        = ::std::pair<K, V>;
+            using reference         = ::std::pair<const K &, ::std::conditional_t<Const, const V &, V &>>;
+            using difference_type   = ::std::ptrdiff_t;
+            using iterator_category = ::std::input_iterator_tag;
+            using iterator_concept  = ::std::random_access_iterator_tag;
+
+            struct arrow_proxy {
+                reference ref;
+                constexpr const reference *operator->() const noexcept {
+                    return &ref;
+                }
+            };
+
+            const K       *_key   = {};
+            mapped_pointer _value = {};
+
+            constexpr operator zip_iterator<true>() const noexcept
+                requires(!Const)
+            {
+                return zip_iterator<true>{_key, _value};
+            }
+
+            [[nodiscard]] constexpr reference operator*() const noexcept {
+                return reference(*_key, *_value);
+            }
+            [[nodiscard]] constexpr arrow_proxy operator->() const noexcept {
+                return arrow_proxy{**this};
+            }
+            [[nodiscard]] constexpr reference operator[](difference_type n) const noexcept {
+                return reference(_key[n], _value[n]);
+            }
+            constexpr zip_iterator &operator++() noexcept {
+                ++_key;
+                ++_value;
+                return *this;
+            }
+            constexpr zip_iterator operator++(int) noexcept {
+                zip_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            constexpr zip_iterator &operator--() noexcept {
+                --_key;
+                --_value;
+                return *this;
+            }
+            constexpr zip_iterator operator--(int) noexcept {
+                zip_iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            constexpr zip_iterator &operator+=(difference_type n) noexcept {
+                _key += n;
+                _value += n;
+                return *this;
+            }
+            constexpr zip_iterator &operator-=(difference_type n) noexcept {
+                _key -= n;
+                _value -= n;
+                return *this;
+            }
+            [[nodiscard]] friend constexpr zip_iterator operator+(zip_iterator it,
+                                                                  difference_type n) noexcept {
+                return it += n;
+            }
+            [[nodiscard]] friend constexpr zip_iterator operator+(difference_type n,
+                                                                  zip_iterator it) noexcept {
+                return it += n;
+            }
+            [[nodiscard]] friend constexpr zip_iterator operator-(zip_iterator it,
+                                                                  difference_type n) noexcept {
+                return it -= n;
+            }
+            [[nodiscard]] friend constexpr difference_type operator-(const zip_iterator &a,
+                                                                     const zip_iterator &b) noexcept {
+                return a._key - b._key;
+            }
+            [[nodiscard]] friend constexpr bool operator==(const zip_iterator &a,
+                                                           const zip_iterator &b) noexcept {
+                return a._key == b._key;
+            }
+            [[nodiscard]] friend constexpr auto operator<=>(const zip_iterator &a,
+                                                            const zip_iterator &b) noexcept {
+                return a._key <=> b._key;
+            }
+        };
+        using iterator       = zip_iterator<false>;
+        using const_iterator = zip_iterator<true>;
+
+      private:
+        key_view_type                     _keys;
+        value_view_type                   _values;
+        [[no_unique_address]] key_compare _comp;
+
+        template <typename RetType>
+        INLINE_VECTOR_FORCEINLINE RetType
+        return_error(RetType ret, [[maybe_unused]] const char *err_msg,
+                     ::std::errc code = ::std::errc::not_enough_memory) noexcept(ErrorPolicy::is_noexcept) {
+            ErrorPolicy::on_error(code, err_msg);
+            return ret;
+        };
+
+        template <typename Key> [[nodiscard]] constexpr size_type lower_index(const Key &key) const {
+            return ::inline_vector::details::branchless_lower_bound(_keys.data(), _keys.size(), key, _comp);
+        }
+        template <typename Key> [[nodiscard]] constexpr size_type upper_index(const Key &key) const {
+            return ::inline_vector::details::branchless_upper_bound(_keys.data(), _keys.size(), key, _comp);
+        }
+        template <typename Key> [[nodiscard]] constexpr size_type find_index(const Key &key) const {
+            size_type idx = lower_index(key);
+            return idx != size() && !_comp(key, _keys[idx]) ? idx : size();
+        }
+        [[nodiscard]] constexpr iterator at_index(size_type idx) noexcept {
+            return iterator{_keys.data() + idx, _values.data() + idx};
+        }
+        [[nodiscard]] constexpr const_iterator at_index(size_type idx) const noexcept {
+            return const_iterator{_keys.data() + idx, _values.data() + idx};
+        }
+        constexpr void erase_index(size_type idx) {
+            _keys.erase(_keys.begin() + idx);
+            _values.erase(_values.begin() + idx);
+        }
+        [[nodiscard]] constexpr bool is_sorted_unique() const {
+            return ::std::adjacent_find(_keys.begin(), _keys.end(),
+                                        [&](const K &a, const K &b) { return !_comp(a, b); }) == _keys.end();
+        }
+
+      public:
+        constexpr inline_flat_map() noexcept = default;
+        // empty map over a key and a value column with room for cap entries each
+        constexpr inline_flat_map(K *keys, V *values, size_type cap, const key_compare &comp = {})
+            : _keys(keys, keys, keys + cap), _values(values, values, values + cap), _comp(comp){};
+        // adopts filled columns, the keys must already be sorted and unique
+        constexpr inline_flat_map(const key_view_type &keys, const value_view_type &values,
+                                  const key_compare &comp = {})
+            : _keys(keys._data, keys._end, keys._cap), _values(values._data, values._end, values._cap),
+              _comp(comp) {
+            assert(_keys.size() == _values.size() && "inline_flat_map columns differ in size");
+            assert(_keys.capacity() == _values.capacity() && "inline_flat_map columns differ in capacity");
+            assert(is_sorted_unique() && "inline_flat_map requires sorted unique keys");
+        };
+        // storage can't be shared, moving hands the columns over
+        inline_flat_map(const inline_flat_map &)            = delete;
+        inline_flat_map &operator=(const inline_flat_map &) = delete;
+        constexpr inline_flat_map(inline_flat_map &&other) noexcept
+            : _keys(::std::move(other._keys)), _values(::std::move(other._values)), _comp(other._comp){};
+        constexpr inline_flat_map &operator=(inline_flat_map &&other) noexcept {
+            if (this != &other) {
+                _keys   = ::std::move(other._keys);
+                _values = ::std::move(other._values);
+                _comp   = other._comp;
+            }
+            return *this;
+        };
+
+        // begin's
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return at_index(0);
+        };
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return at_index(0);
+        };
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return at_index(0);
+        };
+        // end's
+        [[nodiscard]] constexpr iterator end() noexcept {
+            return at_index(size());
+        };
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return at_index(size());
+        };
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return at_index(size());
+        };
+        // keys / values (non-standard), the columns
+        [[nodiscard]] constexpr ::std::span<const K> keys() const noexcept {
+            return {_keys.data(), _keys.size()};
+        };
+        [[nodiscard]] constexpr ::std::span<V> values() noexcept {
+            return {_values.data(), _values.size()};
+        };
+        [[nodiscard]] constexpr ::std::span<const V> values() const noexcept {
+            return {_values.data(), _values.size()};
+        };
+        [[nodiscard]] constexpr key_compare key_comp() const {
+            return _comp;
+        };
+
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _keys.empty();
+        };
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _keys.full();
+        };
+        constexpr size_type size() const noexcept {
+            return _keys.size();
+        };
+        constexpr size_type capacity() const noexcept {
+            return _keys.capacity();
+        };
+        constexpr size_type max_size() const noexcept {
+            return _keys.max_size();
+        };
+
+        // lookups, the template overloads only take part for transparent comparators
+        [[nodiscard]] constexpr iterator lower_bound(const K &key) {
+            return at_index(lower_index(key));
+        }
+        [[nodiscard]] constexpr const_iterator lower_bound(const K &key) const {
+            return at_index(lower_index(key));
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr iterator lower_bound(const Key &key) {
+            return at_index(lower_index(key));
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator lower_bound(const Key &key) const {
+            return at_index(lower_index(key));
+        }
+        [[nodiscard]] constexpr iterator upper_bound(const K &key) {
+            return at_index(upper_index(key));
+        }
+        [[nodiscard]] constexpr const_iterator upper_bound(const K &key) const {
+            return at_index(upper_index(key));
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr iterator upper_bound(const Key &key) {
+            return at_index(upper_index(key));
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator upper_bound(const Key &key) const {
+            return at_index(upper_index(key));
+        }
+        [[nodiscard]] constexpr iterator find(const K &key) {
+            return at_index(find_index(key));
+        }
+        [[nodiscard]] constexpr const_iterator find(const K &key) const {
+            return at_index(find_index(key));
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr iterator find(const Key &key) {
+            return at_index(find_index(key));
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator find(const Key &key) const {
+            return at_index(find_index(key));
+        }
+        [[nodiscard]] constexpr bool contains(const K &key) const {
+            return find_index(key) != size();
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr bool contains(const Key &key) const {
+            return find_index(key) != size();
+        }
+        [[nodiscard]] constexpr size_type count(const K &key) const {
+            return contains(key) ? 1 : 0;
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr size_type count(const Key &key) const {
+            return contains(key) ? 1 : 0;
+        }
+        // get (non-standard), pointer to the value or nullptr
+        [[nodiscard]] constexpr V *get(const K &key) {
+            size_type idx = find_index(key);
+            return idx != size() ? _values.data() + idx : nullptr;
+        }
+        [[nodiscard]] constexpr const V *get(const K &key) const {
+            size_type idx = find_index(key);
+            return idx != size() ? _values.data() + idx : nullptr;
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr V *get(const Key &key) {
+            size_type idx = find_index(key);
+            return idx != size() ? _values.data() + idx : nullptr;
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const V *get(const Key &key) const {
+            size_type idx = find_index(key);
+            return idx != size() ? _values.data() + idx : nullptr;
+        }
+
+        // try_emplace, {position, inserted}, {end(), false} when full
+        template <typename KK, class... Args>
+        constexpr ::std::pair<iterator, bool> try_emplace(KK &&key, Args &&...args) {
+            size_type idx = lower_index(key);
+            if (idx != size() && !_comp(key, _keys[idx]))
+                return {at_index(idx), false};
+            if (ErrorPolicy::checked && full())
+                return return_error(::std::pair<iterator, bool>{end(), false},
+                                    "inline_flat_map cannot allocate to insert elements");
+            _values.emplace(_values.begin() + idx, ::std::forward<Args>(args)...);
+            struct rollback {
+                value_view_type &values;
+                size_type        idx;
+                bool             armed;
+                ~rollback() {
+                    if (armed)
+                        values.erase(values.begin() + idx);
+                }
+            } on_exit{_values, idx, true};
+            _keys.emplace(_keys.begin() + idx, ::std::forward<KK>(key));
+            on_exit.armed = false;
+            return {at_index(idx), true};
+        }
+        constexpr ::std::pair<iterator, bool> insert(const value_type &kv) {
+            return try_emplace(kv.first, kv.second);
+        }
+        constexpr ::std::pair<iterator, bool> insert(value_type &&kv) {
+            return try_emplace(::std::move(kv.first), ::std::move(kv.second));
+        }
+        template <typename M>
+        constexpr ::std::pair<iterator, bool> insert_or_assign(const K &key, M &&value) {
+            size_type idx = lower_index(key);
+            if (idx != size() && !_comp(key, _keys[idx])) {
+                _values[idx] = ::std::forward<M>(value);
+                return {at_index(idx), false};
+            }
+            return try_emplace(key, ::std::forward<M>(value));
+        }
+
+        // insert_sorted_range (non-standard), pair-likes in [first, last) sorted by key (duplicates
+        // allowed) are merged in with one backwards pass, keys already present keep their value.
+        // All or nothing when the new keys don't fit (any policy), returns the number inserted.
+        template <::std::bidirectional_iterator It1>
+        constexpr size_type insert_sorted_range(It1 first, It1 last) {
+            auto key_of = [](const auto &kv) -> decltype(auto) { return ::std::get<0>(kv); };
+            assert(::std::is_sorted(first, last, [&](const auto &a, const auto &b) {
+                       return _comp(key_of(a), key_of(b));
+                   }) && "insert_sorted_range requires input sorted by key");
+            const size_type n     = size();
+            const K        *keys  = _keys.data();
+            size_type       added = 0;
+            size_type       i     = 0;
+            for (It1 it = first; it != last; ++it) {
+                if (it != first && !_comp(key_of(*::std::prev(it)), key_of(*it)))
+                    continue; // duplicate within the input
+                while (i != n && _comp(keys[i], key_of(*it)))
+                    ++i;
+                added += i == n || _comp(key_of(*it), keys[i]);
+            }
+            if (added == 0)
+                return 0;
+            if (ErrorPolicy::checked && added > capacity() - n)
+                return return_error(size_type{0}, "inline_flat_map cannot allocate space to insert");
+
+            K        *kcol = _keys.data();
+            V        *vcol = _values.data();
+            size_type w    = n + added;
+            i              = n;
+            // once w meets i every new key is placed and the prefix is already in position
+            for (It1 it = last; it != first && w != i;) {
+                --it;
+                if (it != first && !_comp(key_of(*::std::prev(it)), key_of(*it)))
+                    continue; // keep the first of equivalent inputs
+                while (i != 0 && _comp(key_of(*it), kcol[i - 1])) {
+                    --i;
+                    --w;
+                    ::inline_vector::details::put_slot(kcol, n, w, ::std::move(kcol[i]));
+                    ::inline_vector::details::put_slot(vcol, n, w, ::std::move(vcol[i]));
+                }
+                if (i != 0 && !_comp(kcol[i - 1], key_of(*it)))
+                    continue; // already present
+                --w;
+                ::inline_vector::details::put_slot(kcol, n, w, key_of(*it));
+                ::inline_vector::details::put_slot(vcol, n, w, ::std::get<1>(*it));
+            }
+            assert(w == i);
+            _keys._end += added;
+            _values._end += added;
+            return added;
+        }
+
+        // erase's
+        constexpr size_type erase(const K &key) {
+            size_type idx = find_index(key);
+            if (idx == size())
+                return 0;
+            erase_index(idx);
+            return 1;
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare> &&
+                     (!::std::is_convertible_v<Key, const_iterator>)
+        constexpr size_type erase(const Key &key) {
+            size_type idx = find_index(key);
+            if (idx == size())
+                return 0;
+            erase_index(idx);
+            return 1;
+        }
+        constexpr iterator erase(const_iterator pos) {
+            size_type idx = pos._key - _keys.data();
+            erase_index(idx);
+            return at_index(idx);
+        }
+        // erase_if (non-standard member), pred sees const_reference, single pass compaction of
+        // both columns, returns the number removed
+        template <class Pred> constexpr size_type erase_if(Pred pred) {
+            K        *kcol = _keys.data();
+            V        *vcol = _values.data();
+            size_type n    = size();
+            size_type w    = 0;
+            for (size_type r = 0; r != n; ++r) {
+                if (pred(const_reference(kcol[r], vcol[r])))
+                    continue;
+                if (w != r) {
+                    kcol[w] = ::std::move(kcol[r]);
+                    vcol[w] = ::std::move(vcol[r]);
+                }
+                ++w;
+            }
+            if constexpr (!::std::is_trivially_destructible<K>::value)
+                ::inline_vector::details::destroy(kcol + w, kcol + n);
+            if constexpr (!::std::is_trivially_destructible<V>::value)
+                ::inline_vector::details::destroy(vcol + w, vcol + n);
+            _keys._end   = kcol + w;
+            _values._end = vcol + w;
+            return n - w;
+        }
+
+        constexpr void swap(inline_flat_map &other) noexcept {
+            _keys.swap(other._keys);
+            _values.swap(other._values);
+            ::std::swap(_comp, other._comp);
+        }
+        constexpr void clear() noexcept {
+            _keys.clear();
+            _values.clear();
+        };
+    };
+} // namespace inline_vector
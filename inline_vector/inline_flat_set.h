@@ -0,0 +1,335 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <utility>
+
+namespace inline_vector {
+    namespace details {
+        template <typename Compare>
+        concept transparent_compare = requires { typename Compare::is_transparent; };
+
+        // index of the first element not ordered before key, the loop only narrows base so the
+        // compare compiles to a conditional move instead of a hard to predict branch
+        template <typename T, typename Key, typename Compare>
+        constexpr size_t branchless_lower_bound(const T *first, size_t n, const Key &key,
+                                                const Compare &comp) {
+            if (n == 0)
+                return 0;
+            const T *base = first;
+            while (n > 1) {
+                const size_t half = n / 2;
+                base              = comp(base[half], key) ? base + half : base;
+                n -= half;
+            }
+            return static_cast<size_t>(base - first) + static_cast<size_t>(comp(*base, key));
+        }
+        // index of the first element key is ordered before
+        template <typename T, typename Key, typename Compare>
+        constexpr size_t branchless_upper_bound(const T *first, size_t n, const Key &key,
+                                                const Compare &comp) {
+            if (n == 0)
+                return 0;
+            const T *base = first;
+            while (n > 1) {
+                const size_t half = n / 2;
+                base              = !comp(key, base[half]) ? base + half : base;
+                n -= half;
+            }
+            return static_cast<size_t>(base - first) + static_cast<size_t>(!comp(key, *base));
+        }
+
+        // writes value to slot dst of a column whose first size slots hold objects, constructing
+        // past them (used by the backwards merges)
+        template <typename T, typename U>
+        constexpr void put_slot(T *col, size_t size, size_t dst, U &&value) {
+            if (dst < size)
+                col[dst] = ::std::forward<U>(value);
+            else
+                ::new ((void *)(col + dst)) T(::std::forward<U>(value));
+        }
+    }; // namespace details
+
+    // sorted unique keys on caller supplied storage, lookups are branchless binary searches and
+    // heterogeneous when Compare is transparent. Capacity errors go through ErrorPolicy like
+    // inline_vector, the set never allocates.
+    template <typename K, typename Compare = ::std::less<K>,
+              typename ErrorPolicy = ::inline_vector::default_error_policy>
+    struct inline_flat_set {
+        using key_type               = K;
+        using value_type             = K;
+        using key_compare            = Compare;
+        using value_compare          = Compare;
+        using size_type              = ::std::size_t;
+        using difference_type        = ::std::ptrdiff_t;
+        using reference              = const K &;
+        using const_reference        = const K &;
+        using pointer                = K *;
+        using const_pointer          = const K *;
+        using iterator               = const K *;
+        using const_iterator         = const K *;
+        using reverse_iterator       = ::std::reverse_iterator<const_iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+        using view_type              = ::inline_vector::inline_vector<K, false, ErrorPolicy>;
+        using error_policy           = ErrorPolicy;
+
+      private:
+        view_type                         _keys;
+        [[no_unique_address]] key_compare _comp;
+
+        template <typename RetType>
+        INLINE_VECTOR_FORCEINLINE RetType
+        return_error(RetType ret, [[maybe_unused]] const char *err_msg,
+                     ::std::errc code = ::std::errc::not_enough_memory) noexcept(ErrorPolicy::is_noexcept) {
+            ErrorPolicy::on_error(code, err_msg);
+            return ret;
+        };
+
+        template <typename Key> [[nodiscard]] constexpr size_type lower_index(const Key &key) const {
+            return ::inline_vector::details::branchless_lower_bound(_keys.data(), _keys.size(), key, _comp);
+        }
+        template <typename Key> [[nodiscard]] constexpr size_type find_index(const Key &key) const {
+            size_type idx = lower_index(key);
+            return idx != size() && !_comp(key, _keys[idx]) ? idx : size();
+        }
+        [[nodiscard]] constexpr bool is_sorted_unique() const {
+            return ::std::adjacent_find(begin(), end(),
+                                        [&](const K &a, const K &b) { return !_comp(a, b); }) == end();
+        }
+
+      public:
+        constexpr inline_flat_set() noexcept = default;
+        // [data, end) must already be sorted and unique
+        constexpr inline_flat_set(pointer data, pointer end, pointer cap, const key_compare &comp = {})
+            : _keys(data, end, cap), _comp(comp) {
+            assert(is_sorted_unique() && "inline_flat_set requires sorted unique keys");
+        };
+        explicit constexpr inline_flat_set(const view_type &keys, const key_compare &comp = {})
+            : inline_flat_set(keys._data, keys._end, keys._cap, comp){};
+        // storage can't be shared, moving hands the buffer over
+        inline_flat_set(const inline_flat_set &)            = delete;
+        inline_flat_set &operator=(const inline_flat_set &) = delete;
+        constexpr inline_flat_set(inline_flat_set &&other) noexcept
+            : _keys(::std::move(other._keys)), _comp(other._comp){};
+        constexpr inline_flat_set &operator=(inline_flat_set &&other) noexcept {
+            if (this != &other) {
+                _keys = ::std::move(other._keys);
+                _comp = other._comp;
+            }
+            return *this;
+        };
+
+        // begin's
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return _keys.begin();
+        };
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return _keys.begin();
+        };
+        // end's
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return _keys.end();
+        };
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return _keys.end();
+        };
+        // rbegin's / rend's
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        };
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        };
+        // keys (non-standard), the sorted storage
+        [[nodiscard]] constexpr ::std::span<const K> keys() const noexcept {
+            return {_keys.data(), _keys.size()};
+        };
+        [[nodiscard]] constexpr key_compare key_comp() const {
+            return _comp;
+        };
+
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _keys.empty();
+        };
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _keys.full();
+        };
+        constexpr size_type size() const noexcept {
+            return _keys.size();
+        };
+        constexpr size_type capacity() const noexcept {
+            return _keys.capacity();
+        };
+        constexpr size_type max_size() const noexcept {
+            return _keys.max_size();
+        };
+
+        // lookups, the template overloads only take part for transparent comparators
+        [[nodiscard]] constexpr const_iterator lower_bound(const K &key) const {
+            return begin() + lower_index(key);
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator lower_bound(const Key &key) const {
+            return begin() + lower_index(key);
+        }
+        [[nodiscard]] constexpr const_iterator upper_bound(const K &key) const {
+            return begin() +
+                   ::inline_vector::details::branchless_upper_bound(_keys.data(), size(), key, _comp);
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator upper_bound(const Key &key) const {
+            return begin() +
+                   ::inline_vector::details::branchless_upper_bound(_keys.data(), size(), key, _comp);
+        }
+        [[nodiscard]] constexpr const_iterator find(const K &key) const {
+            return begin() + find_index(key);
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator find(const Key &key) const {
+            return begin() + find_index(key);
+        }
+        [[nodiscard]] constexpr bool contains(const K &key) const {
+            return find_index(key) != size();
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr bool contains(const Key &key) const {
+            return find_index(key) != size();
+        }
+        [[nodiscard]] constexpr size_type count(const K &key) const {
+            return contains(key) ? 1 : 0;
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr size_type count(const Key &key) const {
+            return contains(key) ? 1 : 0;
+        }
+        [[nodiscard]] constexpr ::std::pair<const_iterator, const_iterator> equal_range(const K &key) const {
+            const_iterator it = find(key);
+            return {it, it == end() ? it : it + 1};
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr ::std::pair<const_iterator, const_iterator>
+        equal_range(const Key &key) const {
+            return {lower_bound(key), upper_bound(key)};
+        }
+
+        // emplace / insert, {position, inserted}, {end(), false} when full
+        template <class... Args> constexpr ::std::pair<const_iterator, bool> emplace(Args &&...args) {
+            K         key(::std::forward<Args>(args)...);
+            size_type idx = lower_index(key);
+            if (idx != size() && !_comp(key, _keys[idx]))
+                return {begin() + idx, false};
+            if (ErrorPolicy::checked && full())
+                return return_error(::std::pair<const_iterator, bool>{end(), false},
+                                    "inline_flat_set cannot allocate to insert elements");
+            _keys.emplace(_keys.begin() + idx, ::std::move(key));
+            return {begin() + idx, true};
+        }
+        constexpr ::std::pair<const_iterator, bool> insert(const K &key) {
+            return emplace(key);
+        }
+        constexpr ::std::pair<const_iterator, bool> insert(K &&key) {
+            return emplace(::std::move(key));
+        }
+        // unsorted input, one insert per element, returns the number inserted
+        template <::std::input_iterator It1> constexpr size_type insert(It1 first, It1 last) {
+            size_type inserted = 0;
+            for (; first != last; ++first)
+                inserted += emplace(*first).second;
+            return inserted;
+        }
+        constexpr size_type insert(::std::initializer_list<K> ilist) {
+            return insert(ilist.begin(), ilist.end());
+        }
+
+        // insert_sorted_range (non-standard), [first, last) sorted by key_comp (duplicates allowed)
+        // is merged in with one backwards pass, keys already present are kept. All or nothing
+        // when the new keys don't fit (any policy), returns the number inserted.
+        template <::std::bidirectional_iterator It1>
+        constexpr size_type insert_sorted_range(It1 first, It1 last) {
+            assert(::std::is_sorted(first, last, _comp) && "insert_sorted_range requires sorted input");
+            const size_type n     = size();
+            const K        *keys  = _keys.data();
+            size_type       added = 0;
+            size_type       i     = 0;
+            for (It1 it = first; it != last; ++it) {
+                if (it != first && !_comp(*::std::prev(it), *it))
+                    continue; // duplicate within the input
+                while (i != n && _comp(keys[i], *it))
+                    ++i;
+                added += i == n || _comp(*it, keys[i]);
+            }
+            if (added == 0)
+                return 0;
+            if (ErrorPolicy::checked && added > capacity() - n)
+                return return_error(size_type{0}, "inline_flat_set cannot allocate space to insert");
+
+            K        *col = _keys.data();
+            size_type w   = n + added;
+            i             = n;
+            // once w meets i every new key is placed and the prefix is already in position
+            for (It1 it = last; it != first && w != i;) {
+                --it;
+                if (it != first && !_comp(*::std::prev(it), *it))
+                    continue; // keep the first of equivalent inputs
+                while (i != 0 && _comp(*it, col[i - 1])) {
+                    --i;
+                    --w;
+                    ::inline_vector::details::put_slot(col, n, w, ::std::move(col[i]));
+                }
+                if (i != 0 && !_comp(col[i - 1], *it))
+                    continue; // already present
+                --w;
+                ::inline_vector::details::put_slot(col, n, w, *it);
+            }
+            assert(w == i);
+            _keys._end += added;
+            return added;
+        }
+
+        // erase's
+        constexpr size_type erase(const K &key) {
+            size_type idx = find_index(key);
+            if (idx == size())
+                return 0;
+            _keys.erase(_keys.begin() + idx);
+            return 1;
+        }
+        template <typename Key>
+            requires ::inline_vector::details::transparent_compare<Compare> &&
+                     (!::std::is_convertible_v<Key, const_iterator>)
+        constexpr size_type erase(const Key &key) {
+            size_type idx = find_index(key);
+            if (idx == size())
+                return 0;
+            _keys.erase(_keys.begin() + idx);
+            return 1;
+        }
+        constexpr const_iterator erase(const_iterator pos) {
+            return _keys.erase(pos);
+        }
+        constexpr const_iterator erase(const_iterator first, const_iterator last) {
+            return _keys.erase(first, last);
+        }
+        template <class Pred> constexpr size_type erase_if(Pred pred) {
+            return _keys.erase_if(pred);
+        }
+
+        constexpr void swap(inline_flat_set &other) noexcept {
+            _keys.swap(other._keys);
+            ::std::swap(_comp, other._comp);
+        }
+        constexpr void clear() noexcept {
+            _keys.clear();
+        };
+    };
+} // namespace inline_vector
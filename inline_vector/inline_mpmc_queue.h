@@ -0,0 +1,268 @@
+#pragma once
+#include "inline_vector.h"
+#include "spin_wait.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace inline_vector {
+    // bounded multi producer / multi consumer queue (Vyukov's sequence numbered cells) on a caller
+    // supplied buffer, never allocates. Every cell carries a sequence number that says whose turn it
+    // is: pos for the producer of position pos, pos + 1 for its consumer and pos + capacity for the
+    // producer of the next lap. A thread claims positions with one CAS on the shared cursor after
+    // checking the cells' sequence numbers, then works on the cells without further contention and
+    // hands each one over with a release store of its sequence number.
+    // Batches claim as many consecutive ready cells as are available (up to n) with a single CAS.
+    // try_* return right away, push / emplace / push_n / pop / pop_n block in std::atomic::wait on
+    // the cell they need once a short spin did not help.
+    // Element constructors, and for pops the move assignment to the destination, must not throw: a
+    // claimed cell has to be handed over, an exception there terminates.
+    template <typename T> struct inline_mpmc_queue {
+        using element_type    = T;
+        using value_type      = typename ::std::remove_cv<T>::type;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+
+      private:
+        struct cell {
+            ::std::atomic<size_type> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            [[nodiscard]] T *value() noexcept {
+                return ::std::launder(reinterpret_cast<T *>(storage));
+            }
+        };
+
+        cell     *_cells = nullptr;
+        size_type _mask  = 0; // capacity - 1, the capacity is a power of two
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<size_type> _enqueue_pos{0};
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<size_type> _dequeue_pos{0};
+        // threads blocked in std::atomic::wait, releases skip the notify (a shared read-modify-write
+        // per cell inside the standard library) while it is 0
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<unsigned> _sleepers{0};
+
+        // the sequence number cell pos holds when it is the producer's (consumer's) turn
+        template <bool Enqueue> [[nodiscard]] static constexpr size_type turn(size_type pos) noexcept {
+            return Enqueue ? pos : pos + 1;
+        }
+        // claims up to n consecutive positions whose cells are ready for this side, stores the first
+        // in first and returns how many, 0 when the queue is full (empty)
+        template <bool Enqueue> [[nodiscard]] size_type claim(size_type n, size_type &first) noexcept {
+            if (_cells == nullptr) [[unlikely]]
+                return 0;
+            ::std::atomic<size_type> &cursor = Enqueue ? _enqueue_pos : _dequeue_pos;
+            size_type                 pos    = cursor.load(::std::memory_order_relaxed);
+            for (;;) {
+                size_type       ready = 0;
+                difference_type diff  = 0;
+                for (; ready < n; ready++) {
+                    size_type seq = _cells[(pos + ready) & _mask].sequence.load(::std::memory_order_acquire);
+                    diff          = static_cast<difference_type>(seq - turn<Enqueue>(pos + ready));
+                    if (diff != 0)
+                        break;
+                }
+                if (ready == 0) {
+                    if (diff < 0) // the previous lap (producer) has not handed the cell over yet
+                        return 0;
+                    pos = cursor.load(::std::memory_order_relaxed); // another thread took pos
+                    continue;
+                }
+                if (cursor.compare_exchange_weak(pos, pos + ready, ::std::memory_order_relaxed)) {
+                    first = pos;
+                    return ready;
+                }
+            }
+        }
+        // after a failed claim: spin a little, yield a little, then sleep until the cell at the cursor
+        // changes (waking a sleeper costs the other side a system call per cell)
+        template <bool Enqueue> void wait_for_turn(unsigned attempt) noexcept {
+            if (attempt < 64 || _cells == nullptr) {
+                ::inline_vector::details::cpu_relax();
+                return;
+            }
+            if (attempt < 128) {
+                ::std::this_thread::yield();
+                return;
+            }
+            const ::std::atomic<size_type> &cursor = Enqueue ? _enqueue_pos : _dequeue_pos;
+            size_type                       pos    = cursor.load(::std::memory_order_relaxed);
+            cell                           &c      = _cells[pos & _mask];
+            // announce the sleep before the last look at the cell, release() checks in the opposite
+            // order, so either it sees the sleeper or the sleeper sees the handed over cell
+            _sleepers.fetch_add(1, ::std::memory_order_seq_cst);
+            size_type seq = c.sequence.load(::std::memory_order_seq_cst);
+            if (static_cast<difference_type>(seq - turn<Enqueue>(pos)) < 0)
+                c.sequence.wait(seq, ::std::memory_order_acquire);
+            _sleepers.fetch_sub(1, ::std::memory_order_relaxed);
+        }
+        // hands cells [first, first + n) to the other side, all stores before the first wake up so a
+        // woken thread finds the whole batch
+        template <bool Enqueue> void release(size_type first, size_type n) noexcept {
+            for (size_type pos = first; pos != first + n; pos++)
+                _cells[pos & _mask].sequence.store(Enqueue ? pos + 1 : pos + _mask + 1,
+                                                   ::std::memory_order_release);
+            ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+            if (_sleepers.load(::std::memory_order_relaxed) == 0) [[likely]]
+                return;
+            for (size_type pos = first; pos != first + n; pos++)
+                _cells[pos & _mask].sequence.notify_all();
+        }
+        template <class... Args> void construct_at(size_type pos, Args &&...args) noexcept {
+            ::new ((void *)_cells[pos & _mask].storage) T(::std::forward<Args>(args)...);
+        }
+        template <typename OutIt> void take_at(size_type pos, OutIt &out) noexcept {
+            T *value = _cells[pos & _mask].value();
+            *out     = ::std::move(*value);
+            ++out;
+            ::inline_vector::details::destroy_at(value);
+        }
+
+      public:
+        constexpr inline_mpmc_queue() noexcept = default;
+        // carves the largest power of two number of cells that fits into buffer, at least 2 (with a
+        // single cell "filled at pos" and "free for pos + 1" would be the same sequence number)
+        inline_mpmc_queue(void *buffer, size_type bytes) noexcept {
+            ::std::uintptr_t base  = reinterpret_cast<::std::uintptr_t>(buffer);
+            size_type        skew  = (alignof(cell) - base % alignof(cell)) % alignof(cell);
+            size_type        cells = bytes > skew ? (bytes - skew) / sizeof(cell) : 0;
+            if (cells < 2)
+                return;
+            size_type cap = ::std::bit_floor(cells);
+            _cells        = reinterpret_cast<cell *>(base + skew);
+            _mask         = cap - 1;
+            for (size_type i = 0; i < cap; i++)
+                ::new ((void *)&_cells[i].sequence)::std::atomic<size_type>(i);
+        }
+        // the atomics pin it in place
+        inline_mpmc_queue(const inline_mpmc_queue &)            = delete;
+        inline_mpmc_queue &operator=(const inline_mpmc_queue &) = delete;
+
+        // bytes a buffer needs for cap (a power of two, at least 2) elements at any alignment
+        [[nodiscard]] static constexpr size_type bytes_for(size_type cap) noexcept {
+            return cap * sizeof(cell) + alignof(cell) - 1;
+        }
+
+        // non-blocking, false (0) when the queue is full (empty)
+        template <class... Args> bool try_emplace(Args &&...args) noexcept {
+            size_type pos;
+            if (!claim<true>(1, pos))
+                return false;
+            construct_at(pos, ::std::forward<Args>(args)...);
+            release<true>(pos, 1);
+            return true;
+        }
+        bool try_push(const T &value) noexcept {
+            return try_emplace(value);
+        }
+        bool try_push(T &&value) noexcept {
+            return try_emplace(::std::move(value));
+        }
+        bool try_pop(T &out) noexcept {
+            size_type pos;
+            if (!claim<false>(1, pos))
+                return false;
+            T *dest = ::std::addressof(out);
+            take_at(pos, dest);
+            release<false>(pos, 1);
+            return true;
+        }
+        // try_push_n (non-standard), copies up to n elements from first, returns how many fit
+        template <::std::input_iterator It> size_type try_push_n(It first, size_type n) noexcept {
+            size_type pos;
+            size_type count = n ? claim<true>(n, pos) : 0;
+            for (size_type i = 0; i < count; i++, ++first)
+                construct_at(pos + i, *first);
+            release<true>(pos, count);
+            return count;
+        }
+        // try_pop_n (non-standard), moves up to n elements to out, returns how many
+        template <typename OutIt> size_type try_pop_n(OutIt out, size_type n) noexcept {
+            size_type pos;
+            size_type count = n ? claim<false>(n, pos) : 0;
+            for (size_type i = 0; i < count; i++)
+                take_at(pos + i, out);
+            release<false>(pos, count);
+            return count;
+        }
+
+        // blocking, wait until there is room (an element)
+        template <class... Args> void emplace(Args &&...args) noexcept {
+            size_type pos;
+            for (unsigned attempt = 0; !claim<true>(1, pos); attempt++)
+                wait_for_turn<true>(attempt);
+            construct_at(pos, ::std::forward<Args>(args)...);
+            release<true>(pos, 1);
+        }
+        void push(const T &value) noexcept {
+            emplace(value);
+        }
+        void push(T &&value) noexcept {
+            emplace(::std::move(value));
+        }
+        void pop(T &out) noexcept {
+            size_type pos;
+            for (unsigned attempt = 0; !claim<false>(1, pos); attempt++)
+                wait_for_turn<false>(attempt);
+            T *dest = ::std::addressof(out);
+            take_at(pos, dest);
+            release<false>(pos, 1);
+        }
+        // push_n (non-standard), copies all n elements from first, in as few batches as room allows
+        template <::std::input_iterator It> void push_n(It first, size_type n) noexcept {
+            for (unsigned attempt = 0; n;) {
+                size_type pos;
+                size_type count = claim<true>(n, pos);
+                if (!count) {
+                    wait_for_turn<true>(attempt++);
+                    continue;
+                }
+                for (size_type i = 0; i < count; i++, ++first)
+                    construct_at(pos + i, *first);
+                release<true>(pos, count);
+                n -= count;
+                attempt = 0;
+            }
+        }
+        // pop_n (non-standard), waits for at least one element, moves up to n to out, returns how many
+        template <typename OutIt> size_type pop_n(OutIt out, size_type n) noexcept {
+            if (n == 0)
+                return 0;
+            size_type pos;
+            size_type count;
+            for (unsigned attempt = 0; !(count = claim<false>(n, pos)); attempt++)
+                wait_for_turn<false>(attempt);
+            for (size_type i = 0; i < count; i++)
+                take_at(pos + i, out);
+            release<false>(pos, count);
+            return count;
+        }
+
+        // clear, destroys what is left (safe to race with other consumers)
+        void clear() noexcept {
+            size_type pos;
+            while (claim<false>(1, pos)) {
+                ::inline_vector::details::destroy_at(_cells[pos & _mask].value());
+                release<false>(pos, 1);
+            }
+        }
+
+        // approximate while other threads are active
+        [[nodiscard]] size_type size() const noexcept {
+            size_type head = _dequeue_pos.load(::std::memory_order_acquire);
+            size_type tail = _enqueue_pos.load(::std::memory_order_acquire);
+            return tail > head ? (::std::min)(tail - head, capacity()) : 0;
+        }
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return _cells ? _mask + 1 : 0;
+        }
+    };
+} // namespace inline_vector
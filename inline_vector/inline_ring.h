@@ -0,0 +1,217 @@
+#pragma once
+#include "inline_vector.h"
+#include "spin_wait.h"
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <utility>
+
+namespace inline_vector {
+    // wait-free single producer / single consumer ring over caller supplied storage of cap slots
+    // (any cap, no power of two needed). The producer owns _tail and the consumer _head, each on
+    // its own cache line next to a cached copy of the other side's index, which is only refreshed
+    // when the cached one says full (empty), so in steady state neither side reads the other's line.
+    // Batches: push_n / pop_n hand out the free (filled) slots as at most two contiguous spans,
+    // wrapping at the end of the storage, and commit_push / commit_pop publish them. try_push_n /
+    // try_pop_n copy an inline_vector's worth of elements in and move them out the same way.
+    // Exactly one thread may use the producer members and one the consumer members at a time.
+    template <typename T> struct inline_ring {
+        using element_type    = T;
+        using value_type      = typename ::std::remove_cv<T>::type;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer         = element_type *;
+        using const_pointer   = const element_type *;
+        using reference       = element_type &;
+
+        // up to two contiguous runs of slots, in ring order
+        struct segments {
+            ::std::span<T> first  = {};
+            ::std::span<T> second = {};
+
+            [[nodiscard]] constexpr size_type size() const noexcept {
+                return first.size() + second.size();
+            }
+            [[nodiscard]] constexpr bool empty() const noexcept {
+                return first.empty();
+            }
+            [[nodiscard]] constexpr reference operator[](size_type i) const noexcept {
+                return i < first.size() ? first[i] : second[i - first.size()];
+            }
+        };
+
+      private:
+        // positions run over [0, 2 * cap) so a full ring (distance cap) and an empty one (distance 0)
+        // differ without a spare slot or a division
+        pointer   _data = {};
+        size_type _cap  = {};
+        // producer line
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<size_type> _tail{0};
+        size_type _head_cache = 0;
+        // consumer line
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<size_type> _head{0};
+        size_type _tail_cache = 0;
+
+        [[nodiscard]] constexpr size_type distance(size_type from, size_type to) const noexcept {
+            return to >= from ? to - from : to + 2 * _cap - from;
+        }
+        [[nodiscard]] constexpr size_type advance(size_type pos, size_type n) const noexcept {
+            pos += n;
+            return pos >= 2 * _cap ? pos - 2 * _cap : pos;
+        }
+        [[nodiscard]] constexpr size_type slot(size_type pos) const noexcept {
+            return pos >= _cap ? pos - _cap : pos;
+        }
+        // the n slots from pos on as at most two runs
+        [[nodiscard]] constexpr segments split(size_type pos, size_type n) const noexcept {
+            size_type at    = slot(pos);
+            size_type first = (::std::min)(n, _cap - at);
+            return segments{{_data + at, first}, {_data, n - first}};
+        }
+
+      public:
+        constexpr inline_ring() noexcept = default;
+        inline_ring(pointer data, size_type cap) noexcept : _data(data), _cap(cap){};
+        // the atomics pin it in place
+        inline_ring(const inline_ring &)            = delete;
+        inline_ring &operator=(const inline_ring &) = delete;
+
+        // producer side
+
+        // try_emplace / try_push, false when the ring is full
+        template <class... Args> bool try_emplace(Args &&...args) {
+            const size_type tail = _tail.load(::std::memory_order_relaxed);
+            if (distance(_head_cache, tail) == _cap) {
+                _head_cache = _head.load(::std::memory_order_acquire);
+                if (distance(_head_cache, tail) == _cap)
+                    return false;
+            }
+            ::new ((void *)(_data + slot(tail))) T(::std::forward<Args>(args)...);
+            _tail.store(advance(tail, 1), ::std::memory_order_release);
+            return true;
+        }
+        bool try_push(const T &value) {
+            return try_emplace(value);
+        }
+        bool try_push(T &&value) {
+            return try_emplace(::std::move(value));
+        }
+        // push_n, up to n free (uninitialized) slots, fewer when the ring is fuller than that.
+        // Construct a prefix of them and commit_push its length.
+        [[nodiscard]] segments push_n(size_type n) noexcept {
+            const size_type tail = _tail.load(::std::memory_order_relaxed);
+            size_type       free = _cap - distance(_head_cache, tail);
+            if (free < n) {
+                _head_cache = _head.load(::std::memory_order_acquire);
+                free        = _cap - distance(_head_cache, tail);
+            }
+            return split(tail, (::std::min)(n, free));
+        }
+        void commit_push(size_type n) noexcept {
+            const size_type tail = _tail.load(::std::memory_order_relaxed);
+            assert(n <= _cap - distance(_head_cache, tail) && "commit_push past the slots push_n handed out");
+            _tail.store(advance(tail, n), ::std::memory_order_release);
+        }
+        // try_push_n (non-standard), copies up to n elements from first, returns how many fit
+        template <::std::input_iterator It> size_type try_push_n(It first, size_type n) {
+            segments slots = push_n(n);
+            struct publish {
+                inline_ring &ring;
+                size_type    done;
+                ~publish() {
+                    ring.commit_push(done);
+                }
+            } on_exit{*this, 0};
+            for (::std::span<T> run : {slots.first, slots.second})
+                for (T &slot : run) {
+                    ::new ((void *)&slot) T(*first);
+                    ++first;
+                    on_exit.done += 1;
+                }
+            return on_exit.done;
+        }
+
+        // consumer side
+
+        // front (non-standard), the oldest element or nullptr when empty
+        [[nodiscard]] pointer front() noexcept {
+            const size_type head = _head.load(::std::memory_order_relaxed);
+            if (head == _tail_cache) {
+                _tail_cache = _tail.load(::std::memory_order_acquire);
+                if (head == _tail_cache)
+                    return nullptr;
+            }
+            return _data + slot(head);
+        }
+        // try_pop, moves the oldest element into out, false when empty
+        bool try_pop(T &out) {
+            pointer p = front();
+            if (!p)
+                return false;
+            out = ::std::move(*p);
+            commit_pop(1);
+            return true;
+        }
+        // pop_n, up to n of the oldest elements, fewer when the ring holds less. Consume a prefix of
+        // them and commit_pop its length, which destroys them and frees the slots.
+        [[nodiscard]] segments pop_n(size_type n) noexcept {
+            const size_type head  = _head.load(::std::memory_order_relaxed);
+            size_type       avail = distance(head, _tail_cache);
+            if (avail < n) {
+                _tail_cache = _tail.load(::std::memory_order_acquire);
+                avail       = distance(head, _tail_cache);
+            }
+            return split(head, (::std::min)(n, avail));
+        }
+        void commit_pop(size_type n) noexcept {
+            const size_type head = _head.load(::std::memory_order_relaxed);
+            assert(n <= distance(head, _tail_cache) && "commit_pop past the elements pop_n handed out");
+            if constexpr (!::std::is_trivially_destructible<T>::value) {
+                segments done = split(head, n);
+                for (::std::span<T> run : {done.first, done.second})
+                    ::inline_vector::details::destroy(run.data(), run.data() + run.size());
+            }
+            _head.store(advance(head, n), ::std::memory_order_release);
+        }
+        // try_pop_n (non-standard), moves up to n of the oldest elements to out, returns how many
+        template <typename OutIt> size_type try_pop_n(OutIt out, size_type n) {
+            segments items = pop_n(n);
+            struct release {
+                inline_ring &ring;
+                size_type    done;
+                ~release() {
+                    ring.commit_pop(done);
+                }
+            } on_exit{*this, 0};
+            for (::std::span<T> run : {items.first, items.second})
+                for (T &item : run) {
+                    *out = ::std::move(item);
+                    ++out;
+                    on_exit.done += 1;
+                }
+            return on_exit.done;
+        }
+        // clear, destroys what is left (consumer side)
+        void clear() noexcept {
+            commit_pop(pop_n(_cap).size());
+        }
+
+        // either side, exact only while the other side is idle
+        [[nodiscard]] size_type size() const noexcept {
+            size_type head = _head.load(::std::memory_order_acquire);
+            size_type n    = distance(head, _tail.load(::std::memory_order_acquire));
+            return (::std::min)(n, _cap); // the tail may have moved on past a head read earlier
+        }
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        }
+        [[nodiscard]] bool full() const noexcept {
+            return size() == _cap;
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return _cap;
+        }
+    };
+} // namespace inline_vector
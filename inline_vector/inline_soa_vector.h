@@ -0,0 +1,363 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <utility>
+
+namespace inline_vector {
+    // struct of arrays sibling of inline_vector, each field Ts[i] lives in its own caller supplied
+    // column so loops touching a few fields only stream those columns. Columns come either one
+    // buffer per field or carved out of a single buffer. Elements are addressed as tuples of
+    // references, push/clear/capacity and error handling follow inline_vector.
+    template <typename ErrorPolicy, typename... Ts> struct basic_inline_soa_vector {
+        static_assert(sizeof...(Ts) > 0, "inline_soa_vector requires at least one field");
+
+        using value_type      = ::std::tuple<Ts...>;
+        using reference       = ::std::tuple<Ts &...>;
+        using const_reference = ::std::tuple<const Ts &...>;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+        using error_policy    = ErrorPolicy;
+        template <size_type I> using field_type = ::std::tuple_element_t<I, ::std::tuple<Ts...>>;
+
+        // random access over the rows, dereferences to a tuple of references (a proxy, like
+        // vector<bool>, so the legacy category is input)
+        template <bool Const> struct zip_iterator {
+            using columns_type =
+                ::std::conditional_t<Const, ::std::tuple<const Ts *...>, ::std::tuple<Ts *...>>;
+            using value_type = ::std::tuple<Ts...>;
+            using reference =
+                ::std::conditional_t<Const, ::std::tuple<const Ts &...>, ::std::tuple<Ts &...>>;
+            using difference_type   = ::std::ptrdiff_t;
+            using iterator_category = ::std::input_iterator_tag;
+            using iterator_concept  = ::std::random_access_iterator_tag;
+
+            columns_type _columns = {};
+            size_type    _idx     = 0;
+
+            constexpr operator zip_iterator<true>() const noexcept
+                requires(!Const)
+            {
+                return zip_iterator<true>{_columns, _idx};
+            }
+
+            [[nodiscard]] constexpr reference operator*() const noexcept {
+                return (*this)[0];
+            }
+            [[nodiscard]] constexpr reference operator[](difference_type n) const noexcept {
+                return ::std::apply([&](auto *...col) { return reference(col[_idx + n]...); }, _columns);
+            }
+            constexpr zip_iterator &operator++() noexcept {
+                ++_idx;
+                return *this;
+            }
+            constexpr zip_iterator operator++(int) noexcept {
+                zip_iterator tmp = *this;
+                ++_idx;
+                return tmp;
+            }
+            constexpr zip_iterator &operator--() noexcept {
+                --_idx;
+                return *this;
+            }
+            constexpr zip_iterator operator--(int) noexcept {
+                zip_iterator tmp = *this;
+                --_idx;
+                return tmp;
+            }
+            constexpr zip_iterator &operator+=(difference_type n) noexcept {
+                _idx += n;
+                return *this;
+            }
+            constexpr zip_iterator &operator-=(difference_type n) noexcept {
+                _idx -= n;
+                return *this;
+            }
+            [[nodiscard]] friend constexpr zip_iterator operator+(zip_iterator it,
+                                                                  difference_type n) noexcept {
+                return it += n;
+            }
+            [[nodiscard]] friend constexpr zip_iterator operator+(difference_type n,
+                                                                  zip_iterator it) noexcept {
+                return it += n;
+            }
+            [[nodiscard]] friend constexpr zip_iterator operator-(zip_iterator it,
+                                                                  difference_type n) noexcept {
+                return it -= n;
+            }
+            [[nodiscard]] friend constexpr difference_type operator-(const zip_iterator &a,
+                                                                     const zip_iterator &b) noexcept {
+                return static_cast<difference_type>(a._idx) - static_cast<difference_type>(b._idx);
+            }
+            [[nodiscard]] friend constexpr bool operator==(const zip_iterator &a,
+                                                           const zip_iterator &b) noexcept {
+                return a._idx == b._idx;
+            }
+            [[nodiscard]] friend constexpr auto operator<=>(const zip_iterator &a,
+                                                            const zip_iterator &b) noexcept {
+                return a._idx <=> b._idx;
+            }
+        };
+        using iterator       = zip_iterator<false>;
+        using const_iterator = zip_iterator<true>;
+
+        ::std::tuple<Ts *...> _columns = {}; // one column per field
+        size_type             _size    = 0;  // number of constructed rows
+        size_type             _cap     = 0;  // number of rows every column has room for
+
+      private:
+        template <typename RetType>
+        INLINE_VECTOR_FORCEINLINE RetType
+        return_error(RetType ret, [[maybe_unused]] const char *err_msg,
+                     ::std::errc code = ::std::errc::not_enough_memory) noexcept(ErrorPolicy::is_noexcept) {
+            ErrorPolicy::on_error(code, err_msg);
+            return ret;
+        };
+
+        // runs fn(column, index) for every column
+        template <typename Fn> constexpr void for_each_column(Fn &&fn) {
+            [&]<size_type... I>(::std::index_sequence<I...>) {
+                (fn(::std::get<I>(_columns), ::std::integral_constant<size_type, I>{}), ...);
+            }(::std::index_sequence_for<Ts...>{});
+        }
+
+        static constexpr size_type align_up(size_type offset, size_type align) noexcept {
+            return (offset + align - 1) & ~(align - 1);
+        }
+        static constexpr size_type max_align = (::std::max)({alignof(Ts)...});
+        // bytes needed past a max_align aligned start for cap rows, columns in field order
+        static constexpr size_type carved_bytes(size_type cap) noexcept {
+            size_type offset = 0;
+            ((offset = align_up(offset, alignof(Ts)) + cap * sizeof(Ts)), ...);
+            return offset;
+        }
+
+        // constructs one row from args, unwinding the columns already built if a field throws
+        template <typename... Args> constexpr void construct_row(size_type idx, Args &&...args) {
+            size_type built = 0;
+            struct unwind {
+                basic_inline_soa_vector &self;
+                size_type               &built;
+                size_type                idx;
+                ~unwind() {
+                    if (built != sizeof...(Ts))
+                        self.for_each_column([&](auto *col, auto I) {
+                            if (I < built)
+                                ::inline_vector::details::destroy_at(col + idx);
+                        });
+                }
+            } on_exit{*this, built, idx};
+            auto fields = ::std::forward_as_tuple(::std::forward<Args>(args)...);
+            for_each_column([&](auto *col, auto I) {
+                using F = ::std::remove_pointer_t<decltype(col)>;
+                ::new ((void *)(col + idx)) F(::std::get<decltype(I)::value>(::std::move(fields)));
+                built += 1;
+            });
+        }
+        constexpr void destroy_rows(size_type first, size_type last) noexcept {
+            for_each_column([&](auto *col, auto) {
+                using F = ::std::remove_pointer_t<decltype(col)>;
+                if constexpr (!::std::is_trivially_destructible<F>::value)
+                    ::inline_vector::details::destroy(col + first, col + last);
+            });
+        }
+
+      public:
+        constexpr basic_inline_soa_vector() noexcept = default;
+        // one caller supplied buffer per field, each with room for cap elements
+        constexpr basic_inline_soa_vector(size_type cap, Ts *...columns) noexcept
+            : _columns(columns...), _size(0), _cap(cap){};
+        // carves bytes of buffer into aligned columns, capacity is however many rows fit
+        basic_inline_soa_vector(void *buffer, size_type bytes) noexcept {
+            constexpr size_type row_bytes = (sizeof(Ts) + ...);
+            ::std::uintptr_t    base      = reinterpret_cast<::std::uintptr_t>(buffer);
+            size_type           skew      = align_up(base, max_align) - base;
+            size_type           avail     = bytes > skew ? bytes - skew : 0;
+            size_type           cap       = avail / row_bytes;
+            while (cap && carved_bytes(cap) > avail) // alignment padding between columns
+                cap -= 1;
+            size_type offset = 0;
+            for_each_column([&](auto *&col, auto) {
+                using F = ::std::remove_pointer_t<::std::remove_reference_t<decltype(col)>>;
+                offset  = align_up(offset, alignof(F));
+                col     = reinterpret_cast<F *>(base + skew + offset);
+                offset += cap * sizeof(F);
+            });
+            _cap = cap;
+        };
+        // storage can't be shared, moving hands the columns over
+        basic_inline_soa_vector(const basic_inline_soa_vector &)            = delete;
+        basic_inline_soa_vector &operator=(const basic_inline_soa_vector &) = delete;
+        constexpr basic_inline_soa_vector(basic_inline_soa_vector &&other) noexcept
+            : _columns(::std::exchange(other._columns, {})), _size(::std::exchange(other._size, 0)),
+              _cap(::std::exchange(other._cap, 0)){};
+        constexpr basic_inline_soa_vector &operator=(basic_inline_soa_vector &&other) noexcept {
+            if (this != &other) {
+                _columns = ::std::exchange(other._columns, {});
+                _size    = ::std::exchange(other._size, 0);
+                _cap     = ::std::exchange(other._cap, 0);
+            }
+            return *this;
+        };
+
+        // bytes a single buffer needs to carve cap rows (plus worst case alignment of the buffer)
+        [[nodiscard]] static constexpr size_type bytes_for(size_type cap) noexcept {
+            return carved_bytes(cap) + max_align - 1;
+        }
+
+        // column access (non-standard)
+        template <size_type I> [[nodiscard]] constexpr field_type<I> *data() noexcept {
+            return ::std::get<I>(_columns);
+        }
+        template <size_type I> [[nodiscard]] constexpr const field_type<I> *data() const noexcept {
+            return ::std::get<I>(_columns);
+        }
+        template <size_type I> [[nodiscard]] constexpr ::std::span<field_type<I>> column() noexcept {
+            return {::std::get<I>(_columns), _size};
+        }
+        template <size_type I>
+        [[nodiscard]] constexpr ::std::span<const field_type<I>> column() const noexcept {
+            return {::std::get<I>(_columns), _size};
+        }
+
+        // front
+        [[nodiscard]] constexpr reference front() {
+            assert(!empty());
+            return (*this)[0];
+        };
+        [[nodiscard]] constexpr const_reference front() const {
+            assert(!empty());
+            return (*this)[0];
+        };
+        // back's
+        [[nodiscard]] constexpr reference back() {
+            assert(!empty());
+            return (*this)[_size - 1];
+        };
+        [[nodiscard]] constexpr const_reference back() const {
+            assert(!empty());
+            return (*this)[_size - 1];
+        };
+        // begin's
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return iterator{_columns, 0};
+        };
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return const_iterator{_columns, 0};
+        };
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return begin();
+        };
+        // end's
+        [[nodiscard]] constexpr iterator end() noexcept {
+            return iterator{_columns, _size};
+        };
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return const_iterator{_columns, _size};
+        };
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return end();
+        };
+        // empty's
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _size == 0;
+        };
+        // full (non standard)
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _size >= _cap;
+        };
+
+        // size
+        constexpr size_type size() const noexcept {
+            return _size;
+        };
+        // capacity
+        constexpr size_type capacity() const noexcept {
+            return _cap;
+        };
+        // max_size (constant)
+        constexpr size_type max_size() const noexcept {
+            return _cap;
+        };
+
+        // emplace_back's, one argument per field
+        template <class... Args>
+        constexpr reference emplace_back(Args &&...args) noexcept(
+            ErrorPolicy::is_noexcept && (::std::is_nothrow_constructible_v<Ts, Args &&> && ...)) {
+            static_assert(sizeof...(Args) == sizeof...(Ts), "emplace_back takes one argument per field");
+            if (!ErrorPolicy::checked || _size < _cap) [[likely]] {
+                return unchecked_emplace_back(::std::forward<Args>(args)...);
+            } else { // error?
+                return_error(false, "inline_soa_vector cannot allocate to insert elements");
+            }
+            return (*this)[_size];
+        };
+        template <class... Args> constexpr reference unchecked_emplace_back(Args &&...args) {
+            static_assert(sizeof...(Args) == sizeof...(Ts), "emplace_back takes one argument per field");
+            construct_row(_size, ::std::forward<Args>(args)...);
+            _size += 1;
+            return (*this)[_size - 1];
+        };
+
+        // push_back's
+        constexpr void push_back(const value_type &value) {
+            ::std::apply([&](const Ts &...fields) { emplace_back(fields...); }, value);
+        }
+        constexpr void push_back(value_type &&value) {
+            ::std::apply([&](Ts &...fields) { emplace_back(::std::move(fields)...); }, value);
+        }
+
+        // pop_back's
+        constexpr void pop_back() noexcept(ErrorPolicy::is_noexcept) {
+            assert((ErrorPolicy::checked || size()) && "inline_soa_vector cannot pop_back when empty");
+            if (!ErrorPolicy::checked || _size) [[likely]] {
+                _size -= 1;
+                destroy_rows(_size, _size + 1);
+            } else { // error?
+                return_error(false, "inline_soa_vector cannot pop_back when empty",
+                             ::std::errc::result_out_of_range);
+            }
+        };
+
+        // erase's, shifts every column's tail down one row
+        constexpr iterator erase(const_iterator pos) {
+            assert(pos._idx < _size);
+            for_each_column(
+                [&](auto *col, auto) { ::std::move(col + pos._idx + 1, col + _size, col + pos._idx); });
+            pop_back();
+            return iterator{_columns, pos._idx};
+        }
+        // unordered_erase's (non-standard), fills the hole from the back row
+        constexpr iterator unordered_erase(const_iterator pos) {
+            assert(pos._idx < _size);
+            if (pos._idx != _size - 1)
+                for_each_column([&](auto *col, auto) { col[pos._idx] = ::std::move(col[_size - 1]); });
+            pop_back();
+            return iterator{_columns, pos._idx};
+        }
+
+        constexpr void swap(basic_inline_soa_vector &other) noexcept {
+            ::std::swap(_columns, other._columns);
+            ::std::swap(_size, other._size);
+            ::std::swap(_cap, other._cap);
+        }
+
+        //[]'s
+        [[nodiscard]] constexpr reference operator[](size_type pos) {
+            return ::std::apply([&](Ts *...col) { return reference(col[pos]...); }, _columns);
+        };
+        [[nodiscard]] constexpr const_reference operator[](size_type pos) const {
+            return ::std::apply([&](Ts *...col) { return const_reference(col[pos]...); }, _columns);
+        };
+
+        constexpr void clear() noexcept {
+            destroy_rows(0, _size);
+            _size = 0;
+        };
+    };
+
+    template <typename... Ts>
+    using inline_soa_vector = basic_inline_soa_vector<::inline_vector::default_error_policy, Ts...>;
+} // namespace inline_vector
@@ -4,20 +4,55 @@
 #include "inline_vector.h"
 #include "std_headers.h"
 
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#else
+#include <io.h>
+#define pipe(fds) _pipe(fds, 4096, 0x8000 /* _O_BINARY */)
+#define read _read
+#define write _write
+#define close _close
+#endif
+
 using namespace std;
 
+// reads fd straight into the spare capacity of v until end of file or v is full, no staging buffer
+static size_t read_into(int fd, inline_vector::inline_vector<char> &v) {
+    size_t total = 0;
+    while (!v.full()) {
+        span<byte> spare = v.spare_capacity();
+        auto       got   = read(fd, spare.data(), static_cast<unsigned>(spare.size()));
+        if (got <= 0) // end of file or error
+            break;
+        // got counts bytes, which are also elements only because the elements are chars (otherwise
+        // commit_back_bytes, and a short read may end inside an element)
+        v.commit_back(static_cast<size_t>(got));
+        total += static_cast<size_t>(got);
+    }
+    return total;
+}
+
 int main()
 {
     std::array<size_t, 32> data;
     inline_vector::inline_vector<size_t> v{data.data(), data.data(), data.data() + data.size()};
 
-    for (size_t i = 0; i < v.capacity(); i++) {
-        v.data()[i] = 0;
-    }
+    // zeroes every element once (a memset), resize_for_overwrite would skip even that
+    v.resize(data.size());
 
-    for (size_t i = 0; i < data.size(); i++)
-        v.unchecked_emplace_back();
-    
+    int fds[2];
+    if (pipe(fds) == 0) {
+        const char message[] = "zero copy ingest";
+        std::array<char, 64> bytes;
+        inline_vector::inline_vector<char> text{bytes.data(), bytes.data(), bytes.data() + bytes.size()};
+        auto written = write(fds[1], message, sizeof(message) - 1);
+        close(fds[1]);
+        size_t got = read_into(fds[0], text);
+        close(fds[0]);
+        if (written < 0 || got != sizeof(message) - 1)
+            return 1;
+        std::cout << string(text.begin(), text.end()) << '\n';
+    }
 
 	return 0;
 }
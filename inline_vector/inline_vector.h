@@ -1,13 +1,30 @@
 ﻿#pragma once
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
+#include <span>
 #include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 
 #include <assert.h>
 
+#if defined(_MSC_VER)
+#define INLINE_VECTOR_FORCEINLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#define INLINE_VECTOR_FORCEINLINE inline __attribute__((always_inline))
+#else
+#define INLINE_VECTOR_FORCEINLINE inline
+#endif
+
 /*
 The MIT License (MIT)
 
@@ -33,7 +50,25 @@ SOFTWARE.
 */
 
 namespace inline_vector {
+    // opt-in trait for types which can be moved to a new address with memcpy/memmove, leaving the
+    // source as raw memory (no destructor call), specialize for your own handle types
+    template <typename T>
+    struct is_trivially_relocatable : ::std::bool_constant<::std::is_trivially_copyable<T>::value> {};
+    template <typename T, typename D>
+    struct is_trivially_relocatable<::std::unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+
+    template <typename T>
+    constexpr const bool is_trivially_relocatable_v = is_trivially_relocatable<::std::remove_cv_t<T>>::value;
+
     namespace details {
+        // true when [It1, It1 + n) -> It2 can be a single memcpy
+        template <typename It1, typename It2>
+        constexpr const bool is_memcpyable =
+            ::std::is_pointer<It1>::value && ::std::is_pointer<It2>::value &&
+            ::std::is_same<::std::remove_cv_t<::std::remove_pointer_t<It1>>,
+                           ::std::remove_cv_t<::std::remove_pointer_t<It2>>>::value &&
+            ::std::is_trivially_copyable<::std::remove_pointer_t<It2>>::value;
+
         template <typename _Ty> constexpr void destroy_at(_Ty *const ptr) {
             ptr->~_Ty();
         }
@@ -42,31 +77,252 @@ namespace inline_vector {
                 ::inline_vector::details::destroy_at(::std::addressof(*first));
         }
 
-        template <typename It1, typename It2> constexpr It1 uninitialized_copy(It1 I, It1 E, It2 Dest) {
-            return ::std::uninitialized_copy(I, E, Dest);
-        }
-        template <typename It1, typename It2> constexpr It1 uninitialized_copy_n(It1 I, size_t C, It2 Dest) {
+        template <typename It1, typename It2> constexpr It2 uninitialized_copy_n(It1 I, size_t C, It2 Dest) {
+            if constexpr (is_memcpyable<It1, It2>) {
+                if (!::std::is_constant_evaluated()) {
+                    if (C)
+                        ::std::memcpy((void *)Dest, (const void *)I, C * sizeof(*Dest));
+                    return Dest + C;
+                }
+            }
             return ::std::uninitialized_copy_n(I, C, Dest);
         }
-        template <typename It1, typename It2> constexpr It1 uninitialized_move(It1 I, It1 E, It2 Dest) {
+        template <typename It1, typename It2> constexpr It2 uninitialized_copy(It1 I, It1 E, It2 Dest) {
+            if constexpr (is_memcpyable<It1, It2>) {
+                if (!::std::is_constant_evaluated())
+                    return ::inline_vector::details::uninitialized_copy_n(I, static_cast<size_t>(E - I),
+                                                                          Dest);
+            }
+            return ::std::uninitialized_copy(I, E, Dest);
+        }
+        template <typename It1, typename It2> constexpr It2 uninitialized_move(It1 I, It1 E, It2 Dest) {
+            if constexpr (is_memcpyable<It1, It2>) {
+                if (!::std::is_constant_evaluated())
+                    return ::inline_vector::details::uninitialized_copy_n(I, static_cast<size_t>(E - I),
+                                                                          Dest);
+            }
             return ::std::uninitialized_copy(::std::make_move_iterator(I), ::std::make_move_iterator(E),
                                              Dest);
         }
-        template <typename It1, typename It2> constexpr It1 uninitialized_move_n(It1 I, size_t C, It2 Dest) {
+        template <typename It1, typename It2> constexpr It2 uninitialized_move_n(It1 I, size_t C, It2 Dest) {
+            if constexpr (is_memcpyable<It1, It2>) {
+                if (!::std::is_constant_evaluated())
+                    return ::inline_vector::details::uninitialized_copy_n(I, C, Dest);
+            }
             return ::std::uninitialized_copy_n(::std::make_move_iterator(I), C, Dest);
         }
+        // shifts the C elements at I to Dest as raw bytes, ranges may overlap, the source is left as
+        // raw memory (only for trivially relocatable T)
+        template <typename T> void relocate_n(T *I, size_t C, T *Dest) noexcept {
+            static_assert(::inline_vector::is_trivially_relocatable_v<T>, "T must be trivially relocatable");
+            if (C)
+                ::std::memmove((void *)Dest, (const void *)I, C * sizeof(T));
+        }
+        // moves the C elements at I into raw memory at Dest (no overlap) and destroys the sources,
+        // a single memcpy for trivially relocatable T
+        template <typename T> void uninitialized_relocate_n(T *I, size_t C, T *Dest) {
+            if constexpr (::inline_vector::is_trivially_relocatable_v<T>) {
+                if (C)
+                    ::std::memcpy((void *)Dest, (const void *)I, C * sizeof(T));
+            } else {
+                ::inline_vector::details::uninitialized_move_n(I, C, Dest);
+                ::inline_vector::details::destroy(I, I + C);
+            }
+        }
         template <typename It1, typename Val1> constexpr void uninitialized_fill(It1 I, It1 E, Val1 Dest) {
             ::std::uninitialized_fill(I, E, Dest);
         }
         template <typename It1, typename Val1> constexpr void uninitialized_fill_n(It1 I, size_t C, Val1 V) {
             ::std::uninitialized_fill_n(I, C, V);
         }
+        // T(), a single memset for arithmetic, enum and pointer T (all zero bits)
+        template <typename T> constexpr void uninitialized_value_construct_n(T *I, size_t C) {
+            if constexpr (::std::is_arithmetic<T>::value || ::std::is_enum<T>::value ||
+                          ::std::is_pointer<T>::value) {
+                if (!::std::is_constant_evaluated()) {
+                    if (C)
+                        ::std::memset((void *)I, 0, C * sizeof(T));
+                    return;
+                }
+            }
+            ::std::uninitialized_value_construct_n(I, C);
+        }
+        // T without (), nothing at all for trivially default constructible T
+        template <typename T> constexpr void uninitialized_default_construct_n(T *I, size_t C) {
+            if constexpr (!::std::is_trivially_default_constructible<T>::value)
+                ::std::uninitialized_default_construct_n(I, C);
+        }
 
-        enum class error_handling : uint8_t { _noop, _saturate, _exception, _error_code };
+        enum class error_handling : uint8_t {
+            _noop,
+            _saturate,
+            _exception,
+            _error_code,
+            _trap,
+            _callback,
+            _unchecked
+        };
+        // policy used by inline_vectors which don't name one
         constexpr const error_handling error_handler = error_handling::_noop;
     }; // namespace details
 
-    template <typename T, bool destruct_on_exit = false> struct inline_vector {
+    // error handling policies, chosen per inline_vector through its ErrorPolicy parameter. checked
+    // says whether capacity is tested at all, saturate whether bulk inserts keep what fits, and
+    // on_error is called when an operation can't be performed (the operation is then skipped).
+
+    // failing operations do nothing
+    struct noop_policy {
+        static constexpr const details::error_handling handling    = details::error_handling::_noop;
+        static constexpr const bool                    checked     = true;
+        static constexpr const bool                    saturate    = false;
+        static constexpr const bool                    is_noexcept = true;
+        static void on_error(::std::errc, const char *) noexcept {};
+    };
+    // bulk inserts are truncated to the remaining capacity, single element inserts are dropped
+    struct saturate_policy {
+        static constexpr const details::error_handling handling    = details::error_handling::_saturate;
+        static constexpr const bool                    checked     = true;
+        static constexpr const bool                    saturate    = true;
+        static constexpr const bool                    is_noexcept = true;
+        static void on_error(::std::errc, const char *) noexcept {};
+    };
+    // std::bad_alloc when out of room, std::domain_error for pop_back on an empty vector
+    struct throw_policy {
+        static constexpr const details::error_handling handling    = details::error_handling::_exception;
+        static constexpr const bool                    checked     = true;
+        static constexpr const bool                    saturate    = false;
+        static constexpr const bool                    is_noexcept = false;
+        [[noreturn]] static void on_error(::std::errc code, [[maybe_unused]] const char *err_msg) {
+            if (code == ::std::errc::not_enough_memory) {
+#if !defined(_MSC_VER) || defined(__clang__)
+                throw ::std::bad_alloc();
+#else
+                throw ::std::bad_alloc(err_msg);
+#endif
+            }
+            throw ::std::domain_error(err_msg);
+        };
+    };
+    // failing operations do nothing and leave their code in a per thread slot, errno style
+    struct error_code_policy {
+        static constexpr const details::error_handling handling    = details::error_handling::_error_code;
+        static constexpr const bool                    checked     = true;
+        static constexpr const bool                    saturate    = false;
+        static constexpr const bool                    is_noexcept = true;
+        static void on_error(::std::errc code, const char *) noexcept {
+            _last_error = code;
+        };
+        [[nodiscard]] static ::std::errc last_error() noexcept {
+            return _last_error;
+        };
+        static void clear_error() noexcept {
+            _last_error = ::std::errc{};
+        };
+
+      private:
+        static inline thread_local ::std::errc _last_error = {};
+    };
+    // stops in the debugger at the failing call in debug builds, behaves like noop_policy with NDEBUG
+    struct trap_policy {
+        static constexpr const details::error_handling handling    = details::error_handling::_trap;
+        static constexpr const bool                    checked     = true;
+        static constexpr const bool                    saturate    = false;
+        static constexpr const bool                    is_noexcept = true;
+        static void on_error(::std::errc, const char *) noexcept {
+#if !defined(NDEBUG)
+#if defined(_MSC_VER)
+            __debugbreak();
+#elif defined(__GNUC__) || defined(__clang__)
+            __builtin_trap();
+#else
+            ::std::abort();
+#endif
+#endif
+        };
+    };
+    // hands the failure to Callback(std::errc, const char *), which may throw
+    template <auto Callback> struct callback_policy {
+        static constexpr const details::error_handling handling    = details::error_handling::_callback;
+        static constexpr const bool                    checked     = true;
+        static constexpr const bool                    saturate    = false;
+        static constexpr const bool                    is_noexcept =
+            noexcept(Callback(::std::errc{}, static_cast<const char *>(nullptr)));
+        static void on_error(::std::errc code, const char *err_msg) noexcept(is_noexcept) {
+            Callback(code, err_msg);
+        };
+    };
+    // no capacity checks at all, the caller guarantees room (asserted in debug builds)
+    struct unchecked_policy {
+        static constexpr const details::error_handling handling    = details::error_handling::_unchecked;
+        static constexpr const bool                    checked     = false;
+        static constexpr const bool                    saturate    = false;
+        static constexpr const bool                    is_noexcept = true;
+        static void on_error(::std::errc, const char *) noexcept {};
+    };
+
+    namespace details {
+        template <error_handling> struct policy_for;
+        template <> struct policy_for<error_handling::_noop> {
+            using type = ::inline_vector::noop_policy;
+        };
+        template <> struct policy_for<error_handling::_saturate> {
+            using type = ::inline_vector::saturate_policy;
+        };
+        template <> struct policy_for<error_handling::_exception> {
+            using type = ::inline_vector::throw_policy;
+        };
+        template <> struct policy_for<error_handling::_error_code> {
+            using type = ::inline_vector::error_code_policy;
+        };
+        template <> struct policy_for<error_handling::_trap> {
+            using type = ::inline_vector::trap_policy;
+        };
+        template <> struct policy_for<error_handling::_unchecked> {
+            using type = ::inline_vector::unchecked_policy;
+        };
+    }; // namespace details
+
+    using default_error_policy = details::policy_for<details::error_handler>::type;
+
+    // what an inline_vector does with its elements and its storage when it goes out of scope, chosen
+    // through its destruct_on_exit parameter: false and true stand for the first two, a
+    // destroy_and_release<Deleter>{} value for the third.
+
+    // nothing, elements and storage go away in bulk with whatever owns them (an arena, a stack frame)
+    struct skip_destruction {
+        static constexpr const bool destroys = false;
+        static constexpr const bool releases = false;
+    };
+    // destroys the elements, the storage belongs to someone else
+    struct destroy_elements {
+        static constexpr const bool destroys = true;
+        static constexpr const bool releases = false;
+    };
+    // destroys the elements, then hands the storage to Deleter(data, capacity), e.g.
+    // inline_vector<T, destroy_and_release<[](T *p, size_t) { ::free(p); }>{}>
+    template <auto Deleter> struct destroy_and_release {
+        static constexpr const bool destroys = true;
+        static constexpr const bool releases = true;
+        template <typename T> static void release(T *data, ::std::size_t capacity) noexcept {
+            Deleter(data, capacity);
+        }
+    };
+
+    namespace details {
+        template <auto Mode> struct exit_policy_for {
+            using type = ::std::remove_cv_t<decltype(Mode)>;
+        };
+        template <> struct exit_policy_for<false> {
+            using type = ::inline_vector::skip_destruction;
+        };
+        template <> struct exit_policy_for<true> {
+            using type = ::inline_vector::destroy_elements;
+        };
+    }; // namespace details
+
+    template <typename T, auto destruct_on_exit = false,
+              typename ErrorPolicy = ::inline_vector::default_error_policy>
+    struct inline_vector {
         using element_type           = T;
         using value_type             = typename ::std::remove_cv<T>::type;
         using const_reference        = const value_type &;
@@ -79,39 +335,32 @@ namespace inline_vector {
         using const_iterator         = const_pointer;
         using reverse_iterator       = ::std::reverse_iterator<iterator>;
         using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+        using error_policy           = ErrorPolicy;
+        using exit_policy            = typename details::exit_policy_for<destruct_on_exit>::type;
 
         pointer _data = {}; // start of constructed range
         pointer _end  = {}; // end of constructed range
         pointer _cap  = {}; // end of entire range
       private:
         template <typename RetType>
-        __forceinline RetType return_error(RetType ret, [[maybe_unused]] const char *err_msg) noexcept(::inline_vector::details::error_handler !=
-                       ::inline_vector::details::error_handling::_exception) {
-            if constexpr (::inline_vector::details::error_handler ==
-                          ::inline_vector::details::error_handling::_noop) {
-                return ret;
-            } else if (::inline_vector::details::error_handler ==
-                       ::inline_vector::details::error_handling::_saturate) {
-                return ret;
-            } else if (::inline_vector::details::error_handler ==
-                       ::inline_vector::details::error_handling::_exception) {
-#if __clang__
-                throw std::bad_alloc();
-#else
-                throw std::bad_alloc(err_msg);
-#endif
+        INLINE_VECTOR_FORCEINLINE RetType
+        return_error(RetType ret, [[maybe_unused]] const char *err_msg,
+                     ::std::errc code = ::std::errc::not_enough_memory) noexcept(ErrorPolicy::is_noexcept) {
+            ErrorPolicy::on_error(code, err_msg);
+            return ret;
+        };
 
-                return ret;
-            } else if (::inline_vector::details::error_handler ==
-                       ::inline_vector::details::error_handling::_error_code) {
-                if constexpr (std::is_same<RetType, iterator>::value) {
-                    return ++ret;
-                } else if (std::is_same<RetType, bool>::value) {
-                    return false;
+        // whether count more elements fit in room, saturating policies clamp count instead of failing
+        [[nodiscard]] static constexpr bool fits(size_type &count, [[maybe_unused]] size_type room) noexcept {
+            if constexpr (ErrorPolicy::checked) {
+                if (count > room) [[unlikely]] {
+                    if constexpr (ErrorPolicy::saturate)
+                        count = room;
+                    else
+                        return false;
                 }
-            } else {
-                return ret;
             }
+            return true;
         };
 
         template <class It1> constexpr iterator append_range(It1 first, It1 last) {
@@ -122,25 +371,28 @@ namespace inline_vector {
             }
 
             if constexpr (::std::is_same<::std::random_access_iterator_tag,
-                                         ::std::iterator_traits<It1>::iterator_category>::value) {
+                                         typename ::std::iterator_traits<It1>::iterator_category>::value) {
                 size_type insert_count = last - first;
-                if (insert_count > (capacity() - size())) { // error? or noop
-                    if constexpr (::inline_vector::details::error_handler !=
-                                  ::inline_vector::details::error_handling::_noop) {
-                        return ret_it = return_error(ret_it, "inline_vector cannot allocate space to insert");
-                    }
+                if (!fits(insert_count, capacity() - size())) { // error? or noop
+                    return ret_it = return_error(ret_it, "inline_vector cannot allocate space to insert");
                 }
                 // already safe from check above*
                 ::inline_vector::details::uninitialized_copy_n(first, insert_count, end());
                 _end += insert_count;
+            } else if constexpr (!ErrorPolicy::checked) {
+                for (; first != last; ++first) {
+                    unchecked_emplace_back(*first);
+                }
             } else {
                 // bounds check each emplace_back, saturating
                 for (; first != last && size() < capacity(); ++first) {
                     unchecked_emplace_back(*first);
                 }
-                if constexpr (::inline_vector::details::error_handler !=
-                              ::inline_vector::details::error_handling::_noop) {
+                if constexpr (!ErrorPolicy::saturate) {
                     if (first != last) {
+                        // all or nothing, drop what was appended
+                        ::inline_vector::details::destroy(ret_it, end());
+                        _end = ret_it;
                         return ret_it = return_error(ret_it, "inline_vector cannot allocate space to insert");
                     }
                 }
@@ -149,6 +401,61 @@ namespace inline_vector {
             return ret_it;
         }
 
+        // shifts the tail at idx up by count slots in one pass, returns how many of the slots in the
+        // gap still hold (moved from) objects, those must be assigned to rather than constructed
+        constexpr size_type open_gap(size_type idx, size_type count) {
+            iterator  pos  = begin() + idx;
+            size_type tail = size() - idx;
+            if constexpr (::inline_vector::is_trivially_relocatable_v<element_type>) {
+                ::inline_vector::details::relocate_n(pos, tail, pos + count);
+                _end += count;
+                return 0;
+            } else {
+                if (tail > count) {
+                    ::inline_vector::details::uninitialized_move(end() - count, end(), end());
+                    ::std::move_backward(pos, end() - count, end());
+                } else {
+                    ::inline_vector::details::uninitialized_move(pos, end(), pos + count);
+                }
+                _end += count;
+                return (::std::min)(tail, count);
+            }
+        }
+
+        // fills count slots of a gap from open_gap, consuming assigned slots first
+        template <class It1>
+        constexpr iterator fill_gap(iterator dest, size_type count, size_type &assigned, It1 first) {
+            for (; count && assigned; --count, --assigned, ++dest, (void)++first)
+                *dest = *first;
+            return ::inline_vector::details::uninitialized_copy_n(first, count, dest);
+        }
+
+        // shrinks to count or constructs the missing elements with construct(dest, n)
+        template <typename Construct> constexpr void resize_with(size_type count, Construct &&construct) {
+            size_type current = size();
+            if (count <= current) {
+                truncate(count);
+                return;
+            }
+            size_type extra = count - current;
+            if (fits(extra, capacity() - current)) [[likely]] {
+                construct(end(), extra);
+                _end += extra;
+            } else {
+                return_error(false, "inline_vector cannot allocate space to insert");
+            }
+        }
+
+        // does what going out of scope does to the current storage, per the exit policy
+        constexpr void exit_storage() noexcept {
+            if constexpr (exit_policy::destroys && !::std::is_trivially_destructible<element_type>::value)
+                ::inline_vector::details::destroy(_data, _end);
+            if constexpr (exit_policy::releases) {
+                if (_data)
+                    exit_policy::release(_data, capacity());
+            }
+        }
+
       public:
 
         constexpr inline_vector() = default;
@@ -161,9 +468,45 @@ namespace inline_vector {
                 this->operator=(other);
         };
 
-        constexpr inline_vector(inline_vector &&other) noexcept {
-            if (!other.empty())
-                this->operator=(::std::move(other));
+        // moving takes the storage over, O(1) and no element is touched, other is left without storage
+        constexpr inline_vector(inline_vector &&other) noexcept
+            : _data(::std::exchange(other._data, nullptr)), _end(::std::exchange(other._end, nullptr)),
+              _cap(::std::exchange(other._cap, nullptr)){};
+
+        // trivial unless the exit policy has work to do (the constraint is checked lazily so the
+        // default policy still allows an incomplete T)
+        constexpr ~inline_vector()
+            requires(!exit_policy::releases &&
+                     (!exit_policy::destroys || ::std::is_trivially_destructible<element_type>::value))
+        = default;
+        constexpr ~inline_vector() {
+            exit_storage();
+        };
+
+        // what release hands out and adopt takes over
+        struct storage {
+            pointer   data     = nullptr;
+            size_type size     = 0; // constructed elements at the front
+            size_type capacity = 0;
+        };
+        // release (non-standard), gives the storage and its elements up untouched, the caller takes
+        // over whatever the exit policy would have done with them, the vector is left without storage
+        [[nodiscard]] constexpr storage release() noexcept {
+            storage s{_data, size(), capacity()};
+            _data = _end = _cap = nullptr;
+            return s;
+        };
+        // adopt (non-standard), takes over data with size constructed elements and room for cap, the
+        // current storage goes through the exit policy first
+        constexpr void adopt(pointer data, size_type size, size_type cap) noexcept {
+            assert(size <= cap && "inline_vector adopts more elements than capacity");
+            exit_storage();
+            _data = data;
+            _end  = data + size;
+            _cap  = data + cap;
+        };
+        constexpr void adopt(storage s) noexcept {
+            adopt(s.data, s.size, s.capacity);
         };
 
         // front
@@ -252,45 +595,48 @@ namespace inline_vector {
         constexpr size_type max_size() const noexcept {
             return (std::numeric_limits<size_type>::max)() / sizeof(value_type);
         };
+        // spare_capacity (non-standard), the raw storage between end() and the end of the range in
+        // bytes, to be filled in place (read, recv, memcpy, placement new) and then appended with
+        // commit_back (a count of elements) or commit_back_bytes (a count of bytes)
+        [[nodiscard]] ::std::span<::std::byte> spare_capacity() noexcept {
+            return {reinterpret_cast<::std::byte *>(_end), (capacity() - size()) * sizeof(element_type)};
+        };
+        // commit_back (non-standard), appends the n elements now living at the front of spare_capacity
+        constexpr void commit_back(size_type n) noexcept {
+            assert(n <= capacity() - size() && "inline_vector cannot commit more than its spare capacity");
+            _end += n;
+        };
+        // commit_back_bytes (non-standard), commit_back for the bytes written, which must be whole
+        // elements, e.g. what read() returned
+        constexpr void commit_back_bytes(size_type bytes) noexcept {
+            assert(bytes % sizeof(element_type) == 0 && "inline_vector commits a partial element");
+            commit_back(bytes / sizeof(element_type));
+        };
 
         // assign's
         constexpr void assign(size_type count, const T &value) {
-            if (count <= capacity()) [[likely]] {
+            if (fits(count, capacity())) [[likely]] {
                 clear();
                 ::inline_vector::details::uninitialized_fill_n(begin(), count, value);
-                _end = count;
+                _end = _data + count;
             } else {
-                if constexpr (::inline_vector::details::error_handler !=
-                              ::inline_vector::details::error_handling::_noop) {
-                    return_error(false, "inline_vector cannot allocate space to insert");
-                }
+                return_error(false, "inline_vector cannot allocate space to insert");
             }
         };
-        template <class It1> constexpr void assign(It1 first, It1 last) {
+        template <::std::input_iterator It1> constexpr void assign(It1 first, It1 last) {
             if constexpr (::std::is_same<::std::random_access_iterator_tag,
-                                         ::std::iterator_traits<It1>::iterator_category>::value) {
+                                         typename ::std::iterator_traits<It1>::iterator_category>::value) {
                 size_type insert_count = last - first;
-                if ((size() + insert_count) <= capacity()) {
+                if (fits(insert_count, capacity())) {
                     clear();
-                    ::inline_vector::details::uninitialized_copy_n(first, insert_count, end());
-                    _end = insert_count;
+                    ::inline_vector::details::uninitialized_copy_n(first, insert_count, begin());
+                    _end = _data + insert_count;
                 } else {
-                    if constexpr (::inline_vector::details::error_handler !=
-                                  ::inline_vector::details::error_handling::_noop) {
-                        return_error(false, "inline_vector cannot allocate space to insert");
-                    }
+                    return_error(false, "inline_vector cannot allocate space to insert");
                 }
             } else {
                 clear();
-                for (; first != last && size() < capacity(); ++first) {
-                    unchecked_emplace_back(*first);
-                }
-                if constexpr (::inline_vector::details::error_handler !=
-                              ::inline_vector::details::error_handling::_noop) {
-                    if (first != last) {
-                        return_error(false, "inline_vector cannot allocate space to insert");
-                    }
-                }
+                append_range(first, last);
             }
         };
         constexpr void assign(::std::initializer_list<T> ilist) {
@@ -303,7 +649,11 @@ namespace inline_vector {
                 return *this;
             size_t rhs_size = other.size();
             size_t lhs_size = size();
-            size_t lhs_cap  = capacity();
+            if (!fits(rhs_size, capacity())) {
+                // problem
+                return_error(false, "inline_vector cannot allocate space to insert");
+                return *this;
+            }
             // the other vector is smaller than us
             if (lhs_size >= rhs_size) {
                 iterator new_end;
@@ -313,35 +663,40 @@ namespace inline_vector {
                     new_end = begin();
                 // destroy excess elements
                 ::inline_vector::details::destroy(new_end, end());
-                _end  = _begin + rhs_size;
+                _end  = _data + rhs_size;
                 return *this;
             }
             // the other vector fits within our capacity
-            if (rhs_size <= lhs_cap) {
-                // copy to initialized memory
-                ::std::copy(other.begin(), other.begin() + lhs_size, begin());
-                // copy to uninitialized memory
-                ::inline_vector::details::uninitialized_copy(other.begin() + lhs_size,
-                                                            other.begin() + rhs_size, begin() + lhs_size);
-                _end = _begin + rhs_size;
-                return *this;
-            }
-            
-            // problem
-            if constexpr (::inline_vector::details::error_handler !=
-                          ::inline_vector::details::error_handling::_noop) {
-                return_error(false, "inline_vector cannot allocate space to insert");
-            }
-
+            // copy to initialized memory
+            ::std::copy(other.begin(), other.begin() + lhs_size, begin());
+            // copy to uninitialized memory
+            ::inline_vector::details::uninitialized_copy(other.begin() + lhs_size, other.begin() + rhs_size,
+                                                        begin() + lhs_size);
+            _end = _data + rhs_size;
             return *this;
         };
+        // moving takes the storage over, the current one goes through the exit policy first
         constexpr inline_vector &operator=(inline_vector &&other) noexcept {
+            if (this != &other)
+                adopt(other.release());
+            return *this;
+        };
+        constexpr inline_vector &operator=(::std::initializer_list<T> ilist) {
+            assign(ilist);
+            return *this;
+        };
+
+        // assign_elements (non-standard), the former move assignment: moves other's elements into
+        // this storage one by one and clears other, both keep their storage
+        constexpr void assign_elements(inline_vector &&other) noexcept(ErrorPolicy::is_noexcept) {
             size_t rhs_size = other.size();
             size_t lhs_size = size();
-            size_t lhs_cap  = capacity();
 
             if (this == &other) {
                 // do nothing
+            } else if (!fits(rhs_size, capacity())) {
+                // problem
+                return_error(false, "inline_vector cannot allocate space to insert");
             } else if (lhs_size >= rhs_size) {
                 // assign
                 iterator new_end;
@@ -354,7 +709,7 @@ namespace inline_vector {
                 _end  = _data + rhs_size;
                 // clear other
                 other.clear();
-            } else if (rhs_size <= lhs_cap) {
+            } else {
                 // copy to initialized memory
                 ::std::move(other.begin(), other.begin() + lhs_size, begin());
                 // copy to uninitialized memory
@@ -363,35 +718,19 @@ namespace inline_vector {
                 _end = _data + rhs_size;
                 other.clear();
             }
-
-            // problem
-            if constexpr (::inline_vector::details::error_handler !=
-                          ::inline_vector::details::error_handling::_noop) {
-                return_error(false, "inline_vector cannot allocate space to insert");
-            }
-
-            return *this;
-        };
-        constexpr inline_vector &operator=(::std::initializer_list<T> ilist) {
-            assign(ilist);
-            return *this;
         };
 
         // append's (non-standard)
         void append(size_type count, const T &value) {
-            size_t space_remaining = capacity() - size();
-            if (count && count <= space_remaining) [[likely]] {
+            if (fits(count, capacity() - size())) [[likely]] {
                 ::inline_vector::details::uninitialized_fill_n(end(), count, value);
                 _end += count;
             } else {
-                if constexpr (::inline_vector::details::error_handler !=
-                              ::inline_vector::details::error_handling::_noop) {
-                    return_error(false, "inline_vector cannot allocate space to insert");
-                }
+                return_error(false, "inline_vector cannot allocate space to insert");
             }
         }
 
-        template <typename It1> void append(It1 first, It1 last) {
+        template <::std::input_iterator It1> void append(It1 first, It1 last) {
             append_range(first, last);
         }
 
@@ -399,21 +738,13 @@ namespace inline_vector {
         // emplace_back's
         template <class... Args>
         constexpr reference
-        emplace_back(Args &&...args) noexcept(::inline_vector::details::error_handler !=
-                                              ::inline_vector::details::error_handling::_exception) {
+        emplace_back(Args &&...args) noexcept(ErrorPolicy::is_noexcept) {
             iterator it = end();
-            if (size() < capacity()) [[likely]] {
+            if (!ErrorPolicy::checked || size() < capacity()) [[likely]] {
                 ::new ((void *)it) T(::std::forward<Args>(args)...);
                 _end += 1;
             } else { // error?
-                if constexpr (::inline_vector::details::error_handler ==
-                              ::inline_vector::details::error_handling::_exception) {
-#if __clang__
-                    throw std::bad_alloc();
-#else
-                    throw std::bad_alloc("inline_vector cannot allocate to insert elements");
-#endif
-                }
+                return_error(false, "inline_vector cannot allocate to insert elements");
             }
             return *it;
         };
@@ -423,7 +754,7 @@ namespace inline_vector {
             size_type insert_idx = pos - cbegin();
             iterator  ret_it     = begin() + insert_idx;
             if (pos == cend()) { // special case for empty vector
-                if (!full()) [[likely]] {
+                if (!ErrorPolicy::checked || !full()) [[likely]] {
                     ::new ((void *)ret_it) T(::std::forward<Args>(args)...);
                     _end += 1;
                     return ret_it;
@@ -435,10 +766,17 @@ namespace inline_vector {
             assert(pos >= cbegin() && "insertion iterator is out of bounds.");
             assert(pos <= cend() && "inserting past the end of the inline_vector.");
             // if full we back out
-            if (full()) {
+            if (ErrorPolicy::checked && full()) {
                 return ret_it = return_error(ret_it, "inline_vector cannot allocate to insert elements");
             }
             T tmp = T(::std::forward<Args>(args)...);
+            if constexpr (::inline_vector::is_trivially_relocatable_v<element_type>) {
+                // slide the tail up one slot as raw bytes and construct into the hole
+                ::inline_vector::details::relocate_n(ret_it, size() - insert_idx, ret_it + 1);
+                ::new ((void *)ret_it) T(::std::move(tmp));
+                _end += 1;
+                return ret_it;
+            }
             // placement new back item, eg... ...insert here, a, b, c, end -> ...insert
             // here, a, a, b, c, (end)
             ::new ((void *)end()) T(::std::move(back()));
@@ -460,12 +798,70 @@ namespace inline_vector {
         constexpr iterator insert(const_iterator pos, T &&value) {
             return emplace(pos, ::std::move(value));
         };
+        constexpr iterator insert(const_iterator pos, size_type count, const T &value) {
+            size_type insert_idx = pos - cbegin();
+            iterator  ret_it     = begin() + insert_idx;
+            assert(pos >= cbegin() && pos <= cend() && "insertion iterator is out of bounds.");
+            if (!fits(count, capacity() - size())) {
+                return ret_it = return_error(ret_it, "inline_vector cannot allocate to insert elements");
+            }
+            if (!count)
+                return ret_it;
+            // value may refer to an element of this vector
+            T         tmp      = value;
+            size_type assigned = open_gap(insert_idx, count);
+            iterator  dest     = ret_it;
+            for (; count && assigned; --count, --assigned, ++dest)
+                *dest = tmp;
+            ::inline_vector::details::uninitialized_fill_n(dest, count, tmp);
+            return ret_it;
+        };
+        template <::std::input_iterator It1>
+        constexpr iterator insert(const_iterator pos, It1 first, It1 last) {
+            size_type insert_idx = pos - cbegin();
+            iterator  ret_it     = begin() + insert_idx;
+            assert(pos >= cbegin() && pos <= cend() && "insertion iterator is out of bounds.");
+            if (first == last)
+                return ret_it;
+
+            if constexpr (::std::forward_iterator<It1>) {
+                size_type count = ::std::distance(first, last);
+                if (!fits(count, capacity() - size())) {
+                    return ret_it = return_error(ret_it, "inline_vector cannot allocate to insert elements");
+                }
+                if constexpr (::std::contiguous_iterator<It1> &&
+                              ::std::is_same<::std::iter_value_t<It1>, value_type>::value) {
+                    // the source may be a slice of this vector, map it through the shift
+                    const T *src     = ::std::to_address(first);
+                    const T *src_end = src + count;
+                    ::std::less<const T *> before;
+                    if (before(src, cend()) && before(cbegin(), src_end)) {
+                        const T  *split    = ::std::clamp(cbegin() + insert_idx, src, src_end);
+                        size_type assigned = open_gap(insert_idx, count);
+                        iterator  dest     = fill_gap(ret_it, split - src, assigned, src);
+                        fill_gap(dest, src_end - split, assigned, begin() + (split - cbegin()) + count);
+                        return ret_it;
+                    }
+                }
+                size_type assigned = open_gap(insert_idx, count);
+                fill_gap(ret_it, count, assigned, first);
+            } else {
+                // single pass input, append what fits then rotate it into place
+                size_type old_size = size();
+                append_range(first, last);
+                ::std::rotate(ret_it, begin() + old_size, end());
+            }
+            return ret_it;
+        };
+        constexpr iterator insert(const_iterator pos, ::std::initializer_list<T> ilist) {
+            return insert(pos, ilist.begin(), ilist.end());
+        };
 
         // push_back's
-        constexpr void push_back(const T &value) noexcept(noexcept(emplace_back)) {
+        constexpr void push_back(const T &value) noexcept(ErrorPolicy::is_noexcept) {
             emplace_back(::std::forward<const T &>(value));
         }
-        constexpr void push_back(T &&value) noexcept(noexcept(emplace_back)) {
+        constexpr void push_back(T &&value) noexcept(ErrorPolicy::is_noexcept) {
             emplace_back(::std::forward<T &&>(value));
         };
         template <class... Args> constexpr reference unchecked_emplace_back(Args &&...args) {
@@ -483,8 +879,9 @@ namespace inline_vector {
         }
 
         // pop_back's
-        constexpr void pop_back() {
-            if (size()) [[likely]] {
+        constexpr void pop_back() noexcept(ErrorPolicy::is_noexcept) {
+            assert((ErrorPolicy::checked || size()) && "inline_vector cannot pop_back when empty");
+            if (!ErrorPolicy::checked || size()) [[likely]] {
                 if constexpr (::std::is_trivially_destructible<element_type>::value) {
                     _end -= 1;
                 } else {
@@ -492,10 +889,8 @@ namespace inline_vector {
                     end()->~T(); // destroy the tailing value
                 }
             } else { // error?
-                if constexpr (::inline_vector::details::error_handler ==
-                              ::inline_vector::details::error_handling::_exception) {
-                    throw std::domain_error("inline_vector cannot pop_back when empty");
-                }
+                return_error(false, "inline_vector cannot pop_back when empty",
+                             ::std::errc::result_out_of_range);
             }
         };
 
@@ -506,6 +901,14 @@ namespace inline_vector {
 
             assert(pos >= cbegin() && pos <= cend() &&
                    "erase iterator is out of bounds of the inline_vector");
+            if constexpr (::inline_vector::is_trivially_relocatable_v<element_type>) {
+                // destroy in place and slide the tail down as raw bytes
+                iterator dest = begin() + erase_idx;
+                ::inline_vector::details::destroy_at(dest);
+                ::inline_vector::details::relocate_n(dest + 1, size() - erase_idx - 1, dest);
+                _end -= 1;
+                return dest;
+            }
             // move on top
             iterator first = begin() + erase_idx + 1;
             iterator last  = end();
@@ -517,6 +920,122 @@ namespace inline_vector {
             _end -= 1;
             return begin() + erase_idx;
         }
+        constexpr iterator erase(const_iterator first, const_iterator last) noexcept(
+            ::std::is_nothrow_move_assignable_v<value_type>) {
+            assert(first >= cbegin() && first <= last && last <= cend() &&
+                   "erase range is out of bounds of the inline_vector");
+            iterator dest = begin() + (first - cbegin());
+            iterator src  = begin() + (last - cbegin());
+            if (dest == src)
+                return dest;
+
+            if constexpr (::inline_vector::is_trivially_relocatable_v<element_type>) {
+                // destroy the range and slide the tail down as raw bytes
+                if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                    ::inline_vector::details::destroy(dest, src);
+                }
+                ::inline_vector::details::relocate_n(src, end() - src, dest);
+                _end -= (src - dest);
+                return dest;
+            }
+            // move the survivors on top, destroy the moved from tail once
+            iterator new_end = ::std::move(src, end(), dest);
+            ::inline_vector::details::destroy(new_end, end());
+            _end = new_end;
+            return dest;
+        }
+
+        // erase_if (non-standard member), single pass compaction, returns the number removed
+        template <class Pred> constexpr size_type erase_if(Pred pred) {
+            iterator  new_end = ::std::remove_if(begin(), end(), pred);
+            size_type removed = end() - new_end;
+            if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                ::inline_vector::details::destroy(new_end, end());
+            }
+            _end = new_end;
+            return removed;
+        }
+
+        // remove_indices (non-standard), [first, last) are ascending indices into this vector,
+        // duplicates are ignored, survivors are compacted in one pass, returns the number removed
+        template <class It1> constexpr size_type remove_indices(It1 first, It1 last) {
+            if (first == last)
+                return 0;
+            iterator write = begin() + *first;
+            iterator read  = write;
+            while (first != last) {
+                size_type idx = *first;
+                assert(idx < size() && "remove_indices index is out of bounds of the inline_vector");
+                assert(begin() + idx >= read && "remove_indices expects ascending indices");
+                // shift the run of survivors before this index down
+                write = ::std::move(read, begin() + idx, write);
+                read  = begin() + idx + 1;
+                for (++first; first != last && static_cast<size_type>(*first) == idx; ++first) {
+                }
+            }
+            write             = ::std::move(read, end(), write);
+            size_type removed = end() - write;
+            if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                ::inline_vector::details::destroy(write, end());
+            }
+            _end = write;
+            return removed;
+        }
+        template <class Range> constexpr size_type remove_indices(const Range &indices) {
+            return remove_indices(::std::begin(indices), ::std::end(indices));
+        }
+
+        // unordered_erase's (non-standard), fill the hole from the back instead of shifting the tail,
+        // O(1) per element but the order of the survivors is not preserved
+        constexpr iterator
+        unordered_erase(const_iterator pos) noexcept(::std::is_nothrow_move_assignable_v<value_type>) {
+            assert(pos >= cbegin() && pos < cend() && "erase iterator is out of bounds of the inline_vector");
+            iterator dest = begin() + (pos - cbegin());
+            iterator last = end() - 1;
+            if constexpr (::inline_vector::is_trivially_relocatable_v<element_type>) {
+                ::inline_vector::details::destroy_at(dest);
+                if (dest != last)
+                    ::inline_vector::details::relocate_n(last, 1, dest);
+            } else {
+                if (dest != last)
+                    *dest = ::std::move(*last);
+                ::inline_vector::details::destroy_at(last);
+            }
+            _end -= 1;
+            return dest;
+        }
+        constexpr iterator unordered_erase(const_iterator first, const_iterator last) noexcept(
+            ::std::is_nothrow_move_assignable_v<value_type>) {
+            assert(first >= cbegin() && first <= last && last <= cend() &&
+                   "erase range is out of bounds of the inline_vector");
+            iterator  dest   = begin() + (first - cbegin());
+            size_type count  = last - first;
+            size_type tail   = cend() - last;
+            size_type nmoved = (::std::min)(count, tail);
+            if constexpr (::inline_vector::is_trivially_relocatable_v<element_type>) {
+                if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                    ::inline_vector::details::destroy(dest, dest + count);
+                }
+                ::inline_vector::details::relocate_n(end() - nmoved, nmoved, dest);
+            } else {
+                ::std::move(end() - nmoved, end(), dest);
+                ::inline_vector::details::destroy(end() - count, end());
+            }
+            _end -= count;
+            return dest;
+        }
+        template <class Pred> constexpr size_type unordered_erase_if(Pred pred) {
+            size_type removed = 0;
+            for (iterator it = begin(); it != end();) {
+                if (pred(*it)) {
+                    unordered_erase(it);
+                    removed += 1;
+                } else {
+                    ++it;
+                }
+            }
+            return removed;
+        }
 
         constexpr void swap(inline_vector &other) noexcept {
             if (this == &other)
@@ -553,6 +1072,36 @@ namespace inline_vector {
             return m;
         }
 
+        // resize's, value initializes (or copies value into) the new elements, all or nothing unless
+        // the policy saturates
+        constexpr void resize(size_type count) {
+            resize_with(count, [](pointer dest, size_type n) {
+                ::inline_vector::details::uninitialized_value_construct_n(dest, n);
+            });
+        };
+        constexpr void resize(size_type count, const T &value) {
+            resize_with(count, [&](pointer dest, size_type n) {
+                ::inline_vector::details::uninitialized_fill_n(dest, n, value);
+            });
+        };
+        // resize_for_overwrite (non-standard), default initializes the new elements, trivial T are left
+        // as whatever the storage held, for elements about to be written anyway
+        constexpr void resize_for_overwrite(size_type count) {
+            resize_with(count, [](pointer dest, size_type n) {
+                ::inline_vector::details::uninitialized_default_construct_n(dest, n);
+            });
+        };
+        // truncate (non-standard), drops the elements from count on (nothing when count >= size()),
+        // a single store for trivially destructible T
+        constexpr void truncate(size_type count) noexcept {
+            if (count >= size())
+                return;
+            if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                ::inline_vector::details::destroy(begin() + count, end());
+            }
+            _end = _data + count;
+        };
+
         constexpr void clear() noexcept {
             if constexpr (!::std::is_trivially_destructible<element_type>::value) {
                 ::inline_vector::details::destroy(begin(), end());
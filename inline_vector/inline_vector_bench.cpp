@@ -0,0 +1,1220 @@
+// inline_vector_bench.cpp : Microbenchmarks comparing inline_vector against the standard containers.
+//
+// usage: inline_vector_bench [--json] [--perf] [--filter <substring>] [--max-size <n>] [--min-time-ms <n>]
+//
+// Every result row is one (container, element, op, size) tuple. The setup for each repetition
+// (refilling, clearing) runs outside of the timed region, timings are reported per item touched by
+// the op so that sizes can be compared directly. With --perf the hardware counters from
+// perf_counters.h are sampled around the same region and reported per item as well, counters
+// which could not be opened are left empty (CSV) or null (JSON), as are all counters of the rows
+// that run on several threads (only the calling thread is counted). The error policies of
+// inline_vector are compared on size_t elements as inline_vector<policy> rows, and the handle
+// layouts (pointer triple vs compact_inline_vector) as "handles" rows touching many small vectors.
+// Struct of arrays vs array of structs is compared on a 64 byte particle whose loop reads two fields.
+// The simd_search.h kernels are compared against the std algorithms as std / simd<level> rows.
+// Sorted lookups compare inline_flat_set and the frozen_index.h layouts against std::set and
+// std::lower_bound on a sorted vector. Concurrent appends from every hardware thread compare
+// concurrent_inline_vector (per element and reserve_back batches) against a mutex around
+// inline_vector::emplace_back. Producer to consumer handoff in batches compares inline_ring and
+// inline_mpmc_queue (blocking push_n / pop_n) against a mutex protected std::deque. The thread_pool.h
+// loops (parallel_for_each / parallel_transform / parallel_reduce) run against their serial versions.
+// Per request scratch vectors come from malloc (std::vector), a monotonic_buffer_resource per request
+// (std::pmr::vector), the inline_buffer_pool freelists or an inline_arena checkpoint.
+
+#include "compact_inline_vector.h"
+#include "concurrent_inline_vector.h"
+#include "frozen_index.h"
+#include "inline_arena.h"
+#include "inline_buffer_pool.h"
+#include "inline_flat_set.h"
+#include "inline_mpmc_queue.h"
+#include "inline_ring.h"
+#include "inline_soa_vector.h"
+#include "inline_vector.h"
+#include "perf_counters.h"
+#include "simd_search.h"
+#include "small_vector.h"
+#include "static_vector.h"
+#include "std_headers.h"
+#include "thread_pool.h"
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bench {
+    struct pod64 {
+        uint64_t v[8];
+    };
+    static_assert(sizeof(pod64) == 64, "pod64 must be 64 bytes");
+
+    template <typename T> struct element_traits;
+    template <> struct element_traits<size_t> {
+        static constexpr const char *name = "size_t";
+        static size_t make(size_t i) {
+            return i;
+        }
+    };
+    template <> struct element_traits<uint32_t> {
+        static constexpr const char *name = "uint32_t";
+        static uint32_t make(size_t i) {
+            return static_cast<uint32_t>(i);
+        }
+    };
+    template <> struct element_traits<pod64> {
+        static constexpr const char *name = "pod64";
+        static pod64 make(size_t i) {
+            pod64 p;
+            for (size_t j = 0; j < 8; j++)
+                p.v[j] = i + j;
+            return p;
+        }
+    };
+    template <> struct element_traits<std::string> {
+        static constexpr const char *name = "std::string";
+        static std::string make(size_t i) {
+            // long enough to defeat the small string optimization
+            std::string s = std::to_string(i);
+            s.resize(24, 'x');
+            return s;
+        }
+    };
+
+    template <typename T> inline void do_not_optimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+    // fixtures, each owns storage for cap elements up front so no op reallocates
+    template <typename T, typename Policy = ::inline_vector::default_error_policy>
+    struct inline_vector_fixture {
+        static constexpr const char *name = "inline_vector";
+        using container                   = ::inline_vector::inline_vector<T, false, Policy>;
+
+        std::allocator<T> alloc;
+        size_t            cap;
+        T                *storage;
+        container         v;
+
+        explicit inline_vector_fixture(size_t c)
+            : cap(c), storage(alloc.allocate(c)), v{storage, storage, storage + c} {};
+        inline_vector_fixture(const inline_vector_fixture &) = delete;
+        ~inline_vector_fixture() {
+            v.clear();
+            alloc.deallocate(storage, cap);
+        }
+        // points v back at its own storage, empty (moves hand the storage to the target)
+        void reseat() {
+            v.clear();
+            v = container{storage, storage, storage + cap};
+        }
+    };
+
+    template <typename T> struct compact_inline_vector_fixture {
+        static constexpr const char *name = "compact_inline_vector";
+        using container                   = ::inline_vector::compact_inline_vector<T>;
+
+        std::allocator<T> alloc;
+        size_t            cap;
+        T                *storage;
+        container         v;
+
+        explicit compact_inline_vector_fixture(size_t c)
+            : cap(c), storage(alloc.allocate(c)), v{storage, storage, storage + c} {};
+        compact_inline_vector_fixture(const compact_inline_vector_fixture &) = delete;
+        ~compact_inline_vector_fixture() {
+            v.clear();
+            alloc.deallocate(storage, cap);
+        }
+        // points v back at its own storage, empty (moves hand the storage to the target)
+        void reseat() {
+            v.clear();
+            v = container{storage, storage, storage + cap};
+        }
+    };
+
+    inline void ignore_error(std::errc, const char *) noexcept {};
+
+    template <typename Policy> struct policy_name;
+    template <> struct policy_name<::inline_vector::noop_policy> {
+        static constexpr const char *value = "inline_vector<noop>";
+    };
+    template <> struct policy_name<::inline_vector::saturate_policy> {
+        static constexpr const char *value = "inline_vector<saturate>";
+    };
+    template <> struct policy_name<::inline_vector::throw_policy> {
+        static constexpr const char *value = "inline_vector<throw>";
+    };
+    template <> struct policy_name<::inline_vector::error_code_policy> {
+        static constexpr const char *value = "inline_vector<error_code>";
+    };
+    template <> struct policy_name<::inline_vector::trap_policy> {
+        static constexpr const char *value = "inline_vector<trap>";
+    };
+    template <> struct policy_name<::inline_vector::callback_policy<&ignore_error>> {
+        static constexpr const char *value = "inline_vector<callback>";
+    };
+    template <> struct policy_name<::inline_vector::unchecked_policy> {
+        static constexpr const char *value = "inline_vector<unchecked>";
+    };
+
+    template <typename Policy> struct policy_fixture {
+        template <typename T> struct type : inline_vector_fixture<T, Policy> {
+            static constexpr const char *name = policy_name<Policy>::value;
+            using inline_vector_fixture<T, Policy>::inline_vector_fixture;
+        };
+    };
+
+    template <typename T> struct std_vector_fixture {
+        static constexpr const char *name = "std::vector";
+        using container                   = std::vector<T>;
+
+        size_t    cap;
+        container v;
+
+        explicit std_vector_fixture(size_t c) : cap(c) {
+            v.reserve(c);
+        };
+    };
+
+    template <typename T> struct pmr_vector_fixture {
+        static constexpr const char *name = "std::pmr::vector";
+        using container                   = std::pmr::vector<T>;
+
+        size_t                              cap;
+        std::unique_ptr<std::byte[]>        buffer;
+        std::pmr::monotonic_buffer_resource resource;
+        container                           v;
+
+        explicit pmr_vector_fixture(size_t c)
+            : cap(c), buffer(new std::byte[c * sizeof(T) * 2 + alignof(T)]),
+              resource(buffer.get(), c * sizeof(T) * 2 + alignof(T)), v(&resource) {
+            v.reserve(c);
+        };
+        pmr_vector_fixture(const pmr_vector_fixture &) = delete;
+    };
+
+    // 8 inline elements, reserved up front like std::vector so the runs measure the heap mode
+    template <typename T> struct small_vector_fixture {
+        static constexpr const char *name = "small_vector";
+        using container                   = ::inline_vector::small_vector<T, 8>;
+
+        size_t    cap;
+        container v;
+
+        explicit small_vector_fixture(size_t c) : cap(c) {
+            v.reserve(c);
+        };
+    };
+
+    // capacity is a template parameter, the object itself lives on the heap so large N fit
+    template <size_t N> struct static_vector_fixture {
+        template <typename T> struct type {
+            static constexpr const char *name = "static_vector";
+            using container                   = ::inline_vector::static_vector<T, N>;
+
+            size_t                     cap;
+            std::unique_ptr<container> holder;
+            container                 &v;
+
+            explicit type(size_t c) : cap(c), holder(new container()), v(*holder) {
+                assert(c == N);
+            };
+        };
+    };
+
+    struct options {
+        bool                     json     = false;
+        bool                     perf     = false;
+        std::string              filter   = {};
+        size_t                   max_size = size_t{1} << 20;
+        std::chrono::nanoseconds min_time = std::chrono::milliseconds(10);
+        size_t                   min_reps = 3;
+        size_t                   max_reps = 100000;
+    };
+
+    // first, 8 * first, ... up to opts.max_size, plus max_size itself so the largest size asked for
+    // always runs (the default 1 << 20 is not a power of 8)
+    inline std::vector<size_t> sizes(const options &opts, size_t first) {
+        std::vector<size_t> out;
+        for (size_t n = first; n <= opts.max_size; n *= 8)
+            out.push_back(n);
+        if (!out.empty() && out.back() != opts.max_size)
+            out.push_back(opts.max_size);
+        return out;
+    }
+
+    struct result {
+        size_t items_per_rep;
+        size_t reps;
+        double ns_per_item_min;
+        double ns_per_item_median;
+        // totals over all reps, only sampled with --perf
+        perf::sample counters;
+    };
+
+    using clock = std::chrono::steady_clock;
+
+    inline double timer_overhead_ns() {
+        static const double overhead = [] {
+            double best = 1e9;
+            for (size_t i = 0; i < 1000; i++) {
+                auto t0 = clock::now();
+                auto t1 = clock::now();
+                best    = (std::min)(best, (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            }
+            return best;
+        }();
+        return overhead;
+    }
+
+    inline perf::counter_group &counters() {
+        static perf::counter_group group;
+        return group;
+    }
+
+    template <typename Setup, typename Op>
+    result measure(const options &opts, size_t items_per_rep, Setup &&setup, Op &&op) {
+        std::vector<double>      samples;
+        std::chrono::nanoseconds total{0};
+        perf::sample             counted;
+        double                   overhead = timer_overhead_ns();
+        while ((total < opts.min_time || samples.size() < opts.min_reps) && samples.size() < opts.max_reps) {
+            setup();
+            if (opts.perf)
+                counters().start();
+            auto t0 = clock::now();
+            op();
+            auto t1 = clock::now();
+            if (opts.perf)
+                counted += counters().stop();
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0);
+            total += ns;
+            samples.push_back((std::max)(0.0, (double)ns.count() - overhead) / (double)items_per_rep);
+        }
+        std::sort(samples.begin(), samples.end());
+        return result{items_per_rep, samples.size(), samples.front(), samples[samples.size() / 2], counted};
+    }
+
+    // ops that run on more than one thread, the counters only follow the calling thread (pid 0, no
+    // inherit) so they would put the work of the others on nobody, these rows report no counters
+    template <typename Setup, typename Op>
+    result measure_threads(const options &opts, size_t items_per_rep, Setup &&setup, Op &&op) {
+        options untracked = opts;
+        untracked.perf    = false;
+        return measure(untracked, items_per_rep, std::forward<Setup>(setup), std::forward<Op>(op));
+    }
+
+    struct reporter {
+        const options &opts;
+        bool           first = true;
+
+        explicit reporter(const options &o) : opts(o) {
+            if (opts.json) {
+                std::cout << "[\n";
+            } else {
+                std::cout << "container,element,op,size,items_per_rep,reps,ns_per_item_min,ns_per_item_median";
+                if (opts.perf) {
+                    for (size_t i = 0; i < perf::counter_count; i++)
+                        std::cout << ',' << perf::counter_name(static_cast<perf::counter>(i)) << "_per_item";
+                    std::cout << ",ipc";
+                }
+                std::cout << '\n';
+            }
+        }
+        ~reporter() {
+            if (opts.json)
+                std::cout << "\n]\n";
+        }
+
+        static void print_counter(const result &r, perf::counter c, const char *missing) {
+            if (r.counters.has(c))
+                std::cout << (double)r.counters[c] / (double)(r.items_per_rep * r.reps);
+            else
+                std::cout << missing;
+        }
+        static void print_ipc(const result &r, const char *missing) {
+            if (r.counters.has(perf::counter::cycles) && r.counters.has(perf::counter::instructions) &&
+                r.counters[perf::counter::cycles] != 0)
+                std::cout << (double)r.counters[perf::counter::instructions] /
+                                 (double)r.counters[perf::counter::cycles];
+            else
+                std::cout << missing;
+        }
+
+        void row(const char *container, const char *element, const char *op, size_t size, const result &r) {
+            if (opts.json) {
+                std::cout << (first ? "  " : ",\n  ") << "{\"container\": \"" << container << "\", \"element\": \""
+                          << element << "\", \"op\": \"" << op << "\", \"size\": " << size
+                          << ", \"items_per_rep\": " << r.items_per_rep << ", \"reps\": " << r.reps
+                          << ", \"ns_per_item_min\": " << r.ns_per_item_min
+                          << ", \"ns_per_item_median\": " << r.ns_per_item_median;
+                if (opts.perf) {
+                    for (size_t i = 0; i < perf::counter_count; i++) {
+                        std::cout << ", \"" << perf::counter_name(static_cast<perf::counter>(i))
+                                  << "_per_item\": ";
+                        print_counter(r, static_cast<perf::counter>(i), "null");
+                    }
+                    std::cout << ", \"ipc\": ";
+                    print_ipc(r, "null");
+                }
+                std::cout << "}";
+            } else {
+                std::cout << container << ',' << element << ',' << op << ',' << size << ',' << r.items_per_rep
+                          << ',' << r.reps << ',' << r.ns_per_item_min << ',' << r.ns_per_item_median;
+                if (opts.perf) {
+                    for (size_t i = 0; i < perf::counter_count; i++) {
+                        std::cout << ',';
+                        print_counter(r, static_cast<perf::counter>(i), "");
+                    }
+                    std::cout << ',';
+                    print_ipc(r, "");
+                }
+                std::cout << '\n';
+            }
+            std::cout.flush();
+            first = false;
+        }
+    };
+
+    template <typename Container, typename T> void refill(Container &v, const std::vector<T> &src, size_t n) {
+        v.clear();
+        v.assign(src.begin(), src.begin() + n);
+    }
+
+    template <template <typename> class Fixture, typename T>
+    void run_container(const options &opts, reporter &out, const std::vector<T> &src) {
+        const size_t n       = src.size();
+        const char  *cname   = Fixture<T>::name;
+        const char  *ename   = element_traits<T>::name;
+        auto         enabled = [&](const char *op) {
+            if (opts.filter.empty())
+                return true;
+            std::string key = std::string(cname) + '/' + ename + '/' + op;
+            return key.find(opts.filter) != std::string::npos;
+        };
+
+        Fixture<T> f(n);
+        auto      &v = f.v;
+
+        if (enabled("emplace_back")) {
+            out.row(cname, ename, "emplace_back", n,
+                    measure(
+                        opts, n, [&] { v.clear(); },
+                        [&] {
+                            for (size_t i = 0; i < n; i++)
+                                v.emplace_back(src[i]);
+                            do_not_optimize(v.data());
+                        }));
+        }
+
+        if constexpr (requires { v.unchecked_emplace_back(src[0]); }) {
+            if (enabled("unchecked_emplace_back")) {
+                out.row(cname, ename, "unchecked_emplace_back", n,
+                        measure(
+                            opts, n, [&] { v.clear(); },
+                            [&] {
+                                for (size_t i = 0; i < n; i++)
+                                    v.unchecked_emplace_back(src[i]);
+                                do_not_optimize(v.data());
+                            }));
+            }
+        }
+
+        if (enabled("append")) {
+            out.row(cname, ename, "append", n,
+                    measure(
+                        opts, n, [&] { v.clear(); },
+                        [&] {
+                            if constexpr (requires { v.append(src.begin(), src.end()); })
+                                v.append(src.begin(), src.end());
+                            else
+                                v.insert(v.end(), src.begin(), src.end());
+                            do_not_optimize(v.data());
+                        }));
+        }
+
+        if (enabled("assign")) {
+            out.row(cname, ename, "assign", n,
+                    measure(
+                        opts, n, [&] { refill(v, src, n); },
+                        [&] {
+                            v.assign(src.begin(), src.end());
+                            do_not_optimize(v.data());
+                        }));
+        }
+
+        // k inserts/erases in the middle of a vector that ends up (or starts) at n elements
+        const size_t k = (std::min)(n / 2, size_t{64});
+        if (enabled("emplace")) {
+            out.row(cname, ename, "emplace", n,
+                    measure(
+                        opts, k, [&] { refill(v, src, n - k); },
+                        [&] {
+                            for (size_t i = 0; i < k; i++)
+                                v.emplace(v.begin() + v.size() / 2, src[i]);
+                            do_not_optimize(v.data());
+                        }));
+        }
+
+        // the same k elements inserted as one run
+        if (enabled("insert_range")) {
+            out.row(cname, ename, "insert_range", n,
+                    measure(
+                        opts, k, [&] { refill(v, src, n - k); },
+                        [&] {
+                            v.insert(v.begin() + v.size() / 2, src.begin(), src.begin() + k);
+                            do_not_optimize(v.data());
+                        }));
+        }
+
+        if (enabled("erase")) {
+            out.row(cname, ename, "erase", n,
+                    measure(
+                        opts, k, [&] { refill(v, src, n); },
+                        [&] {
+                            for (size_t i = 0; i < k; i++)
+                                v.erase(v.begin() + v.size() / 2);
+                            do_not_optimize(v.data());
+                        }));
+        }
+
+        if constexpr (requires { v.unordered_erase(v.begin()); }) {
+            if (enabled("unordered_erase")) {
+                out.row(cname, ename, "unordered_erase", n,
+                        measure(
+                            opts, k, [&] { refill(v, src, n); },
+                            [&] {
+                                for (size_t i = 0; i < k; i++)
+                                    v.unordered_erase(v.begin() + v.size() / 2);
+                                do_not_optimize(v.data());
+                            }));
+            }
+        }
+
+        // drop every other element in one call
+        if (enabled("erase_if")) {
+            out.row(cname, ename, "erase_if", n,
+                    measure(
+                        opts, n, [&] { refill(v, src, n); },
+                        [&] {
+                            auto odd = [base = v.data()](const T &x) { return ((&x - base) & 1) != 0; };
+                            if constexpr (requires { v.erase_if(odd); })
+                                v.erase_if(odd);
+                            else
+                                std::erase_if(v, odd);
+                            do_not_optimize(v.data());
+                        }));
+        }
+
+        if (enabled("clear")) {
+            out.row(cname, ename, "clear", n,
+                    measure(
+                        opts, n, [&] { refill(v, src, n); },
+                        [&] {
+                            v.clear();
+                            do_not_optimize(v.data());
+                        }));
+        }
+
+        if (enabled("copy_assign") || enabled("move_assign")) {
+            Fixture<T> other(n);
+            auto      &w = other.v;
+            refill(w, src, n);
+
+            if (enabled("copy_assign")) {
+                out.row(cname, ename, "copy_assign", n,
+                        measure(
+                            opts, n, [&] { v.clear(); },
+                            [&] {
+                                v = w;
+                                do_not_optimize(v.data());
+                            }));
+            }
+
+            if (enabled("move_assign")) {
+                // the handle containers steal w's storage, both go back to their own before every rep
+                constexpr bool reseats = requires { f.reseat(); };
+                out.row(cname, ename, "move_assign", n,
+                        measure(
+                            opts, n,
+                            [&] {
+                                if constexpr (reseats) {
+                                    f.reseat();
+                                    other.reseat();
+                                } else {
+                                    v.clear();
+                                }
+                                refill(w, src, n);
+                            },
+                            [&] {
+                                v = std::move(w);
+                                do_not_optimize(v.data());
+                            }));
+                if constexpr (reseats)
+                    f.reseat();
+            }
+        }
+
+        v.clear();
+    }
+
+    // sizes are 8^(I+1) or the default max_size, matching run_element's loop (any other --max-size
+    // has no static_vector row at that size)
+    template <typename T, size_t... I>
+    void run_static_vector(const options &opts, reporter &out, const std::vector<T> &src,
+                           std::index_sequence<I...>) {
+        ((src.size() == (size_t{8} << (3 * I))
+              ? run_container<static_vector_fixture<(size_t{8} << (3 * I))>::template type>(opts, out, src)
+              : void()),
+         ...);
+        constexpr size_t default_max = options{}.max_size;
+        if (src.size() == default_max && ((default_max != (size_t{8} << (3 * I))) && ...))
+            run_container<static_vector_fixture<default_max>::template type>(opts, out, src);
+    }
+
+    template <typename T> void run_element(const options &opts, reporter &out) {
+        for (size_t n : sizes(opts, 8)) {
+            std::vector<T> src;
+            src.reserve(n);
+            for (size_t i = 0; i < n; i++)
+                src.push_back(element_traits<T>::make(i));
+
+            run_container<inline_vector_fixture>(opts, out, src);
+            run_container<compact_inline_vector_fixture>(opts, out, src);
+            run_container<std_vector_fixture>(opts, out, src);
+            run_container<pmr_vector_fixture>(opts, out, src);
+            run_static_vector(opts, out, src, std::make_index_sequence<6>{});
+            run_container<small_vector_fixture>(opts, out, src);
+        }
+    }
+
+    template <typename... Policies> void run_policies(const options &opts, reporter &out) {
+        for (size_t n : sizes(opts, 8)) {
+            std::vector<size_t> src;
+            src.reserve(n);
+            for (size_t i = 0; i < n; i++)
+                src.push_back(element_traits<size_t>::make(i));
+
+            (run_container<policy_fixture<Policies>::template type>(opts, out, src), ...);
+        }
+    }
+
+    // n handles of slots elements each over one shared buffer, like per node adjacency lists, the
+    // handle array is what gets streamed so its layout decides how many handles a cache line holds
+    template <typename Handle> void run_handles(const options &opts, reporter &out, const char *cname) {
+        constexpr size_t slots = 4;
+        const char      *ename = element_traits<uint32_t>::name;
+        for (size_t n : sizes(opts, 8)) {
+            auto enabled = [&](const char *op) {
+                if (opts.filter.empty())
+                    return true;
+                std::string key = std::string(cname) + '/' + ename + '/' + op;
+                return key.find(opts.filter) != std::string::npos;
+            };
+
+            std::vector<uint32_t> storage(n * slots);
+            std::vector<Handle>   handles;
+            handles.reserve(n);
+            for (size_t i = 0; i < n; i++) {
+                uint32_t *base = storage.data() + i * slots;
+                handles.emplace_back(base, base, base + slots);
+            }
+            auto reset = [&] {
+                for (Handle &h : handles)
+                    h.clear();
+            };
+
+            if (enabled("handles_emplace_back")) {
+                out.row(cname, ename, "handles_emplace_back", n,
+                        measure(opts, n, reset, [&] {
+                            for (size_t i = 0; i < n; i++)
+                                handles[i].emplace_back(static_cast<uint32_t>(i));
+                            do_not_optimize(handles.data());
+                        }));
+            }
+
+            if (enabled("handles_size")) {
+                for (size_t i = 0; i < n; i++)
+                    for (size_t j = 0; j < i % slots; j++)
+                        handles[i].emplace_back(static_cast<uint32_t>(j));
+                out.row(cname, ename, "handles_size", n,
+                        measure(
+                            opts, n, [] {},
+                            [&] {
+                                size_t total = 0;
+                                for (const Handle &h : handles)
+                                    total += h.size();
+                                do_not_optimize(total);
+                            }));
+            }
+        }
+    }
+
+    struct particle {
+        double   x, y, z, vx, vy, vz, mass;
+        uint64_t id;
+    };
+    static_assert(sizeof(particle) == 64, "particle must be 64 bytes");
+
+    // x += vx over every particle, the array of structs streams all 64 bytes per element while the
+    // struct of arrays only streams the two columns involved
+    inline void run_soa(const options &opts, reporter &out) {
+        using soa_type = ::inline_vector::inline_soa_vector<double, double, double, double, double, double,
+                                                            double, uint64_t>;
+        const char *ename = "particle";
+        for (size_t n : sizes(opts, 8)) {
+            auto enabled = [&](const char *cname) {
+                if (opts.filter.empty())
+                    return true;
+                std::string key = std::string(cname) + '/' + ename + "/update_x";
+                return key.find(opts.filter) != std::string::npos;
+            };
+
+            if (enabled("inline_vector")) {
+                inline_vector_fixture<particle> f(n);
+                for (size_t i = 0; i < n; i++)
+                    f.v.emplace_back(particle{0.0, 0.0, 0.0, (double)i, 0.0, 0.0, 1.0, i});
+                out.row("inline_vector", ename, "update_x", n,
+                        measure(
+                            opts, n, [] {},
+                            [&] {
+                                for (particle &p : f.v)
+                                    p.x += p.vx;
+                                do_not_optimize(f.v.data());
+                            }));
+            }
+
+            if (enabled("inline_soa_vector")) {
+                std::unique_ptr<std::byte[]> buffer(new std::byte[soa_type::bytes_for(n)]);
+                soa_type                     v(buffer.get(), soa_type::bytes_for(n));
+                for (size_t i = 0; i < n; i++)
+                    v.emplace_back(0.0, 0.0, 0.0, (double)i, 0.0, 0.0, 1.0, uint64_t{i});
+                out.row("inline_soa_vector", ename, "update_x", n,
+                        measure(
+                            opts, n, [] {},
+                            [&] {
+                                double       *x  = v.data<0>();
+                                const double *vx = v.data<3>();
+                                for (size_t i = 0; i < v.size(); i++)
+                                    x[i] += vx[i];
+                                do_not_optimize(x);
+                            }));
+            }
+        }
+    }
+
+    // linear membership style searches, the needle is absent so every op scans all n elements
+    template <typename T> void run_search(const options &opts, reporter &out) {
+        namespace simd     = ::inline_vector::simd;
+        const char *ename  = element_traits<T>::name;
+        const T     needle = element_traits<T>::make(opts.max_size + 1);
+        struct variant {
+            const char *name;
+            simd::level level;
+        };
+        const variant variants[] = {{"std", simd::level::scalar},
+                                    {"simd<sse2>", simd::level::sse2},
+                                    {"simd<avx2>", simd::level::avx2},
+                                    {"simd<avx512>", simd::level::avx512}};
+        const simd::level detected = simd::active_level();
+
+        for (size_t n : sizes(opts, 64)) {
+            inline_vector_fixture<T> f(n);
+            for (size_t i = 0; i < n; i++)
+                f.v.emplace_back(element_traits<T>::make((i * 7919) % n));
+
+            for (const variant &var : variants) {
+                if (var.level > detected)
+                    continue;
+                simd::limit_level(var.level);
+                const bool use_std = var.level == simd::level::scalar;
+                auto       enabled = [&](const char *op) {
+                    if (opts.filter.empty())
+                        return true;
+                    std::string key = std::string(var.name) + '/' + ename + '/' + op;
+                    return key.find(opts.filter) != std::string::npos;
+                };
+                auto run = [&](const char *op, auto &&fn) {
+                    if (enabled(op))
+                        out.row(var.name, ename, op, n,
+                                measure(opts, n, [] {}, [&] { do_not_optimize(fn()); }));
+                };
+
+                run("find", [&] {
+                    return use_std ? std::find(f.v.begin(), f.v.end(), needle) : simd::find(f.v, needle);
+                });
+                run("count", [&] {
+                    return use_std ? (size_t)std::count(f.v.begin(), f.v.end(), needle)
+                                   : simd::count(f.v, needle);
+                });
+                run("min_element", [&] {
+                    return use_std ? std::min_element(f.v.begin(), f.v.end()) : simd::min_element(f.v);
+                });
+            }
+            simd::limit_level(detected);
+        }
+    }
+
+    // random hit and miss probes into n sorted keys, timed per probe
+    inline void run_lookup(const options &opts, reporter &out) {
+        using T                     = uint32_t;
+        const char      *ename      = element_traits<T>::name;
+        constexpr size_t probes     = 1024;
+        uint64_t         rng        = 0x9e3779b97f4a7c15ull;
+        auto             next_probe = [&](size_t n) {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            return (T)(rng % (2 * n)); // odd keys only are stored, so half the probes miss
+        };
+        auto enabled = [&](const char *cname) {
+            if (opts.filter.empty())
+                return true;
+            std::string key = std::string(cname) + '/' + ename + "/find";
+            return key.find(opts.filter) != std::string::npos;
+        };
+
+        for (size_t n : sizes(opts, 64)) {
+            std::vector<T> probe(probes);
+            for (T &p : probe)
+                p = next_probe(n);
+
+            if (enabled("std::set")) {
+                std::set<T> s;
+                for (size_t i = 0; i < n; i++)
+                    s.insert((T)(2 * i + 1));
+                out.row("std::set", ename, "find", n, measure(opts, probes, [] {}, [&] {
+                            size_t hits = 0;
+                            for (T p : probe)
+                                hits += s.find(p) != s.end();
+                            do_not_optimize(hits);
+                        }));
+            }
+
+            if (enabled("std::lower_bound")) {
+                std::vector<T> v;
+                for (size_t i = 0; i < n; i++)
+                    v.push_back((T)(2 * i + 1));
+                out.row("std::lower_bound", ename, "find", n, measure(opts, probes, [] {}, [&] {
+                            size_t hits = 0;
+                            for (T p : probe) {
+                                auto it = std::lower_bound(v.begin(), v.end(), p);
+                                hits += it != v.end() && *it == p;
+                            }
+                            do_not_optimize(hits);
+                        }));
+            }
+
+            if (enabled("inline_flat_set")) {
+                inline_vector_fixture<T> f(n);
+                for (size_t i = 0; i < n; i++)
+                    f.v.emplace_back((T)(2 * i + 1));
+                ::inline_vector::inline_flat_set<T> s(f.v);
+                out.row("inline_flat_set", ename, "find", n, measure(opts, probes, [] {}, [&] {
+                            size_t hits = 0;
+                            for (T p : probe)
+                                hits += s.contains(p);
+                            do_not_optimize(hits);
+                        }));
+            }
+
+            auto run_frozen = [&](const char *cname, auto tag) {
+                using index = decltype(tag);
+                if (!enabled(cname))
+                    return;
+                std::vector<T> v;
+                for (size_t i = 0; i < n; i++)
+                    v.push_back((T)(2 * i + 1));
+                std::unique_ptr<std::byte[]> buffer(new std::byte[index::bytes_for(n)]);
+                index                        frozen(v.data(), n, buffer.get(), index::bytes_for(n));
+                out.row(cname, ename, "find", n, measure(opts, probes, [] {}, [&] {
+                            size_t hits = 0;
+                            for (T p : probe)
+                                hits += frozen.contains(p);
+                            do_not_optimize(hits);
+                        }));
+            };
+            run_frozen("eytzinger_index", ::inline_vector::eytzinger_index<T>{});
+            run_frozen("stree_index", ::inline_vector::stree_index<T>{});
+        }
+    }
+
+    // every hardware thread appends n / threads elements into one shared buffer, the threads are
+    // started inside the timed region so only sizes where that amortizes are run
+    inline void run_concurrent(const options &opts, reporter &out) {
+        using T                = size_t;
+        const char    *ename   = element_traits<T>::name;
+        const unsigned threads = (std::max)(2u, std::thread::hardware_concurrency());
+        auto           enabled = [&](const char *cname) {
+            if (opts.filter.empty())
+                return true;
+            std::string key = std::string(cname) + '/' + ename + "/emplace_back_mt";
+            return key.find(opts.filter) != std::string::npos;
+        };
+        auto run_threads = [&](size_t n, auto &&append) {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; t++)
+                workers.emplace_back([&, t] {
+                    for (size_t i = t; i < n; i += threads)
+                        append(i);
+                });
+            for (std::thread &w : workers)
+                w.join();
+        };
+
+        for (size_t n : sizes(opts, 32768)) {
+            if (enabled("inline_vector+mutex")) {
+                inline_vector_fixture<T> f(n);
+                std::mutex               lock;
+                out.row("inline_vector+mutex", ename, "emplace_back_mt", n,
+                        measure_threads(
+                            opts, n, [&] { f.v.clear(); },
+                            [&] {
+                                run_threads(n, [&](size_t i) {
+                                    std::lock_guard<std::mutex> hold(lock);
+                                    f.v.emplace_back(i);
+                                });
+                                do_not_optimize(f.v.data());
+                            }));
+            }
+
+            if (enabled("concurrent_inline_vector")) {
+                inline_vector_fixture<T>                    f(n);
+                ::inline_vector::concurrent_inline_vector<T> v(f.v);
+                out.row("concurrent_inline_vector", ename, "emplace_back_mt", n,
+                        measure_threads(
+                            opts, n, [&] { v.clear(); },
+                            [&] {
+                                run_threads(n, [&](size_t i) { v.emplace_back(i); });
+                                do_not_optimize(v.data());
+                            }));
+            }
+
+            // same elements, each thread claims 16 slots at a time and commits them after constructing
+            if (enabled("concurrent_inline_vector<reserve_back>")) {
+                inline_vector_fixture<T>                    f(n);
+                ::inline_vector::concurrent_inline_vector<T> v(f.v);
+                constexpr size_t                            batch = 16;
+                out.row("concurrent_inline_vector<reserve_back>", ename, "emplace_back_mt", n,
+                        measure_threads(
+                            opts, n, [&] { v.clear(); },
+                            [&] {
+                                std::vector<std::thread> workers;
+                                for (unsigned t = 0; t < threads; t++)
+                                    workers.emplace_back([&, t] {
+                                        for (size_t i = t * batch; i < n; i += threads * batch) {
+                                            std::span<T> slots = v.reserve_back((std::min)(batch, n - i));
+                                            for (size_t j = 0; j < slots.size(); j++)
+                                                ::new ((void *)&slots[j]) T(i + j);
+                                            v.commit(slots);
+                                        }
+                                    });
+                                for (std::thread &w : workers)
+                                    w.join();
+                                do_not_optimize(v.data());
+                            }));
+            }
+        }
+    }
+
+    // a producer thread hands n elements to a consumer thread in batches of 64, both yield when the
+    // other side has to catch up
+    inline void run_handoff(const options &opts, reporter &out) {
+        using T                = size_t;
+        const char      *ename = element_traits<T>::name;
+        constexpr size_t batch = 64;
+        auto             enabled = [&](const char *cname) {
+            if (opts.filter.empty())
+                return true;
+            std::string key = std::string(cname) + '/' + ename + "/handoff";
+            return key.find(opts.filter) != std::string::npos;
+        };
+
+        for (size_t n : sizes(opts, 32768)) {
+            std::vector<T> source(n);
+            for (size_t i = 0; i < n; i++)
+                source[i] = element_traits<T>::make(i);
+
+            if (enabled("std::deque+mutex")) {
+                std::deque<T> queue;
+                std::mutex    lock;
+                out.row("std::deque+mutex", ename, "handoff", n, measure_threads(opts, n, [] {}, [&] {
+                            std::thread producer([&] {
+                                for (size_t i = 0; i < n; i += batch) {
+                                    std::lock_guard<std::mutex> hold(lock);
+                                    queue.insert(queue.end(), source.begin() + i,
+                                                 source.begin() + (std::min)(i + batch, n));
+                                }
+                            });
+                            T sum = 0;
+                            for (size_t got = 0; got < n;) {
+                                T      taken[batch];
+                                size_t count = 0;
+                                {
+                                    std::lock_guard<std::mutex> hold(lock);
+                                    count = (std::min)(batch, queue.size());
+                                    std::copy_n(queue.begin(), count, taken);
+                                    queue.erase(queue.begin(), queue.begin() + count);
+                                }
+                                for (size_t i = 0; i < count; i++)
+                                    sum += taken[i];
+                                got += count;
+                                if (count == 0)
+                                    std::this_thread::yield();
+                            }
+                            producer.join();
+                            do_not_optimize(sum);
+                        }));
+            }
+
+            if (enabled("inline_ring")) {
+                std::vector<T>                  storage(64 * batch);
+                ::inline_vector::inline_ring<T> ring(storage.data(), storage.size());
+                out.row("inline_ring", ename, "handoff", n, measure_threads(opts, n, [] {}, [&] {
+                            std::thread producer([&] {
+                                for (size_t i = 0; i < n;) {
+                                    size_t pushed =
+                                        ring.try_push_n(source.begin() + i, (std::min)(batch, n - i));
+                                    i += pushed;
+                                    if (pushed == 0)
+                                        std::this_thread::yield();
+                                }
+                            });
+                            T sum = 0;
+                            for (size_t got = 0; got < n;) {
+                                auto items = ring.pop_n(batch);
+                                for (size_t i = 0; i < items.size(); i++)
+                                    sum += items[i];
+                                ring.commit_pop(items.size());
+                                got += items.size();
+                                if (items.empty())
+                                    std::this_thread::yield();
+                            }
+                            producer.join();
+                            do_not_optimize(sum);
+                        }));
+            }
+
+            if (enabled("inline_mpmc_queue")) {
+                using queue_type = ::inline_vector::inline_mpmc_queue<T>;
+                std::vector<std::byte> storage(queue_type::bytes_for(64 * batch));
+                queue_type             queue(storage.data(), storage.size());
+                out.row("inline_mpmc_queue", ename, "handoff", n, measure_threads(opts, n, [] {}, [&] {
+                            std::thread producer([&] {
+                                for (size_t i = 0; i < n; i += batch)
+                                    queue.push_n(source.begin() + i, (std::min)(batch, n - i));
+                            });
+                            T sum = 0;
+                            for (size_t got = 0; got < n;) {
+                                T      taken[batch];
+                                size_t count = queue.pop_n(taken, batch);
+                                for (size_t i = 0; i < count; i++)
+                                    sum += taken[i];
+                                got += count;
+                            }
+                            producer.join();
+                            do_not_optimize(sum);
+                        }));
+            }
+        }
+    }
+
+    // one pool for every row, its workers sleep between repetitions
+    inline void run_parallel(const options &opts, reporter &out) {
+        using T                      = size_t;
+        const char                  *ename = element_traits<T>::name;
+        ::inline_vector::thread_pool pool;
+        auto                         enabled = [&](const char *cname, const char *op) {
+            if (opts.filter.empty())
+                return true;
+            std::string key = std::string(cname) + '/' + ename + '/' + op;
+            return key.find(opts.filter) != std::string::npos;
+        };
+        auto step = [](T x) { return x * 2654435761u + 1; };
+
+        for (size_t n : sizes(opts, 32768)) {
+            inline_vector_fixture<T> f(n);
+            inline_vector_fixture<T> dest(n);
+            for (size_t i = 0; i < n; i++)
+                f.v.emplace_back(element_traits<T>::make(i));
+
+            if (enabled("inline_vector", "for_each"))
+                out.row("inline_vector", ename, "for_each", n, measure(opts, n, [] {}, [&] {
+                            std::for_each(f.v.begin(), f.v.end(), [&](T &x) { x = step(x); });
+                            do_not_optimize(f.v.data());
+                        }));
+            if (enabled("inline_vector+thread_pool", "for_each"))
+                out.row("inline_vector+thread_pool", ename, "for_each", n,
+                        measure_threads(opts, n, [] {}, [&] {
+                            ::inline_vector::parallel_for_each(pool, f.v, [&](T &x) { x = step(x); });
+                            do_not_optimize(f.v.data());
+                        }));
+
+            if (enabled("inline_vector", "transform"))
+                out.row("inline_vector", ename, "transform", n,
+                        measure(opts, n, [&] { dest.v.clear(); }, [&] {
+                            for (const T &x : f.v)
+                                dest.v.unchecked_emplace_back(step(x));
+                            do_not_optimize(dest.v.data());
+                        }));
+            if (enabled("inline_vector+thread_pool", "transform"))
+                out.row("inline_vector+thread_pool", ename, "transform", n,
+                        measure_threads(opts, n, [&] { dest.v.clear(); }, [&] {
+                            ::inline_vector::parallel_transform(pool, f.v, dest.v, step);
+                            do_not_optimize(dest.v.data());
+                        }));
+
+            if (enabled("inline_vector", "reduce"))
+                out.row("inline_vector", ename, "reduce", n, measure(opts, n, [] {}, [&] {
+                            do_not_optimize(std::reduce(f.v.begin(), f.v.end(), T{0}));
+                        }));
+            if (enabled("inline_vector+thread_pool", "reduce"))
+                out.row("inline_vector+thread_pool", ename, "reduce", n, measure_threads(opts, n, [] {}, [&] {
+                            T sum = ::inline_vector::parallel_reduce(pool, f.v, T{0}, std::plus<T>{});
+                            do_not_optimize(sum);
+                        }));
+        }
+    }
+
+    // per request scratch: every request builds a few short lived vectors and drops them together
+    inline void run_scratch(const options &opts, reporter &out) {
+        using T                  = size_t;
+        const char      *ename   = element_traits<T>::name;
+        constexpr size_t vectors = 4;
+        constexpr size_t per     = 16;
+        constexpr size_t request = vectors * per; // elements per request
+        auto             enabled = [&](const char *cname) {
+            if (opts.filter.empty())
+                return true;
+            std::string key = std::string(cname) + '/' + ename + "/scratch";
+            return key.find(opts.filter) != std::string::npos;
+        };
+
+        for (size_t n : sizes(opts, 32768)) {
+            if (enabled("std::vector"))
+                out.row("std::vector", ename, "scratch", n, measure(opts, n, [] {}, [&] {
+                            for (size_t r = 0; r < n; r += request) {
+                                T sum = 0;
+                                for (size_t k = 0; k < vectors; k++) {
+                                    std::vector<T> v;
+                                    v.reserve(per);
+                                    for (size_t i = 0; i < per; i++)
+                                        v.push_back(r + i);
+                                    sum += v.back();
+                                }
+                                do_not_optimize(sum);
+                            }
+                        }));
+
+            if (enabled("std::pmr::vector")) {
+                std::unique_ptr<std::byte[]> buffer(new std::byte[4096]);
+                out.row("std::pmr::vector", ename, "scratch", n, measure(opts, n, [] {}, [&] {
+                            for (size_t r = 0; r < n; r += request) {
+                                std::pmr::monotonic_buffer_resource resource(
+                                    buffer.get(), 4096, std::pmr::null_memory_resource());
+                                T sum = 0;
+                                for (size_t k = 0; k < vectors; k++) {
+                                    std::pmr::vector<T> v(&resource);
+                                    v.reserve(per);
+                                    for (size_t i = 0; i < per; i++)
+                                        v.push_back(r + i);
+                                    sum += v.back();
+                                }
+                                do_not_optimize(sum);
+                            }
+                        }));
+            }
+
+            if (enabled("inline_buffer_pool")) {
+                using pool = ::inline_vector::inline_buffer_pool;
+                out.row("inline_buffer_pool", ename, "scratch", n, measure(opts, n, [] {}, [&] {
+                            for (size_t r = 0; r < n; r += request) {
+                                T sum = 0;
+                                for (size_t k = 0; k < vectors; k++) {
+                                    auto v = pool::acquire<T>(per);
+                                    for (size_t i = 0; i < per; i++)
+                                        v.push_back(r + i);
+                                    sum += v.back();
+                                    pool::release(v);
+                                }
+                                do_not_optimize(sum);
+                            }
+                        }));
+            }
+
+            if (enabled("inline_arena")) {
+                ::inline_vector::inline_arena arena(4096);
+                out.row("inline_arena", ename, "scratch", n, measure(opts, n, [] {}, [&] {
+                            for (size_t r = 0; r < n; r += request) {
+                                auto scope = arena.checkpoint();
+                                T    sum   = 0;
+                                for (size_t k = 0; k < vectors; k++) {
+                                    auto &v = *arena.make_vector<T>(per);
+                                    for (size_t i = 0; i < per; i++)
+                                        v.push_back(r + i);
+                                    sum += v.back();
+                                }
+                                do_not_optimize(sum);
+                            }
+                        }));
+            }
+        }
+    }
+} // namespace bench
+
+int main(int argc, char **argv) {
+    bench::options opts;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            opts.json = true;
+        } else if (std::strcmp(argv[i], "--perf") == 0) {
+            opts.perf = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            opts.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            opts.max_size = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            opts.min_time = std::chrono::milliseconds(std::strtoull(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--json] [--perf] [--filter <substring>] [--max-size <n>] [--min-time-ms <n>]\n";
+            return 1;
+        }
+    }
+
+    if (opts.perf && !bench::counters().available())
+        std::cerr << "warning: perf_event_open is unavailable, counter columns will be empty\n";
+
+    bench::reporter out(opts);
+    bench::run_element<size_t>(opts, out);
+    bench::run_element<bench::pod64>(opts, out);
+    bench::run_element<std::string>(opts, out);
+    bench::run_policies<::inline_vector::noop_policy, ::inline_vector::saturate_policy,
+                        ::inline_vector::throw_policy, ::inline_vector::error_code_policy,
+                        ::inline_vector::trap_policy, ::inline_vector::callback_policy<&bench::ignore_error>,
+                        ::inline_vector::unchecked_policy>(opts, out);
+    bench::run_handles<::inline_vector::inline_vector<uint32_t>>(opts, out, "inline_vector");
+    bench::run_handles<::inline_vector::compact_inline_vector<uint32_t>>(opts, out,
+                                                                          "compact_inline_vector");
+    bench::run_soa(opts, out);
+    bench::run_search<uint32_t>(opts, out);
+    bench::run_lookup(opts, out);
+    bench::run_concurrent(opts, out);
+    bench::run_handoff(opts, out);
+    bench::run_parallel(opts, out);
+    bench::run_scratch(opts, out);
+
+    return 0;
+}
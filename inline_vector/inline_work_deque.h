@@ -0,0 +1,122 @@
+#pragma once
+#include "inline_vector.h"
+#include "spin_wait.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace inline_vector {
+    // fixed capacity work stealing deque (Chase-Lev, with the C++11 orderings of Le et al.) on a caller
+    // supplied buffer, never allocates and never grows. The owning thread pushes and pops at the
+    // bottom (LIFO, the most recently split work is the hottest in cache), any other thread steals from
+    // the top (FIFO, the oldest and usually largest piece of work). Only the last element and steals
+    // race on the top index, every other owner operation is a plain load and store.
+    // Elements are copied through std::atomic<T> slots, so T must be trivially copyable and lock free
+    // as an atomic, typically an index or a packed range.
+    template <typename T> struct inline_work_deque {
+        static_assert(::std::is_trivially_copyable<T>::value && ::std::atomic<T>::is_always_lock_free,
+                      "inline_work_deque elements are copied through lock free atomics");
+        using element_type    = T;
+        using value_type      = typename ::std::remove_cv<T>::type;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+
+      private:
+        using slot = ::std::atomic<T>;
+
+        slot           *_slots = nullptr;
+        difference_type _mask  = 0; // capacity - 1, the capacity is a power of two
+        // indices only grow, [top, bottom) are the elements, contended by thieves
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<difference_type> _top{0};
+        // written by the owner only
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<difference_type> _bottom{0};
+
+      public:
+        constexpr inline_work_deque() noexcept = default;
+        // carves the largest power of two number of slots that fits into buffer
+        inline_work_deque(void *buffer, size_type bytes) noexcept {
+            ::std::uintptr_t base  = reinterpret_cast<::std::uintptr_t>(buffer);
+            size_type        skew  = (alignof(slot) - base % alignof(slot)) % alignof(slot);
+            size_type        slots = bytes > skew ? (bytes - skew) / sizeof(slot) : 0;
+            if (slots == 0)
+                return;
+            size_type cap = ::std::bit_floor(slots);
+            _slots        = reinterpret_cast<slot *>(base + skew);
+            _mask         = static_cast<difference_type>(cap - 1);
+            for (size_type i = 0; i < cap; i++)
+                ::new ((void *)&_slots[i]) slot();
+        }
+        // the atomics pin it in place
+        inline_work_deque(const inline_work_deque &)            = delete;
+        inline_work_deque &operator=(const inline_work_deque &) = delete;
+
+        // bytes a buffer needs for cap (a power of two) elements at any alignment
+        [[nodiscard]] static constexpr size_type bytes_for(size_type cap) noexcept {
+            return cap * sizeof(slot) + alignof(slot) - 1;
+        }
+
+        // owner side
+
+        // try_push, false when the deque is full
+        bool try_push(T value) noexcept {
+            difference_type b = _bottom.load(::std::memory_order_relaxed);
+            difference_type t = _top.load(::std::memory_order_acquire);
+            if (_slots == nullptr || b - t > _mask) [[unlikely]]
+                return false;
+            _slots[b & _mask].store(value, ::std::memory_order_relaxed);
+            ::std::atomic_thread_fence(::std::memory_order_release);
+            _bottom.store(b + 1, ::std::memory_order_relaxed);
+            return true;
+        }
+        // try_pop, the most recently pushed element, false when empty or a thief took the last one
+        bool try_pop(T &out) noexcept {
+            difference_type b = _bottom.load(::std::memory_order_relaxed) - 1;
+            _bottom.store(b, ::std::memory_order_relaxed);
+            ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+            difference_type t = _top.load(::std::memory_order_relaxed);
+            if (t > b) { // empty
+                _bottom.store(b + 1, ::std::memory_order_relaxed);
+                return false;
+            }
+            out = _slots[b & _mask].load(::std::memory_order_relaxed);
+            if (t == b) { // the last element, race the thieves for it
+                bool won = _top.compare_exchange_strong(t, t + 1, ::std::memory_order_seq_cst,
+                                                        ::std::memory_order_relaxed);
+                _bottom.store(b + 1, ::std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        // thief side, any thread
+
+        // try_steal, the oldest element, false when empty or another thread won the race for it
+        bool try_steal(T &out) noexcept {
+            difference_type t = _top.load(::std::memory_order_acquire);
+            ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+            difference_type b = _bottom.load(::std::memory_order_acquire);
+            if (t >= b)
+                return false;
+            out = _slots[t & _mask].load(::std::memory_order_relaxed);
+            return _top.compare_exchange_strong(t, t + 1, ::std::memory_order_seq_cst,
+                                                ::std::memory_order_relaxed);
+        }
+
+        // approximate while other threads are active
+        [[nodiscard]] size_type size() const noexcept {
+            difference_type b = _bottom.load(::std::memory_order_relaxed);
+            difference_type t = _top.load(::std::memory_order_relaxed);
+            return b > t ? static_cast<size_type>(b - t) : 0;
+        }
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return _slots ? static_cast<size_type>(_mask) + 1 : 0;
+        }
+    };
+} // namespace inline_vector
@@ -0,0 +1,186 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters for the benchmarks, backed by perf_event_open on Linux.
+// Counters are opened as a single group so they are scheduled (and read) together, counters the
+// kernel refuses to open (no PMU, perf_event_paranoid, virtualized hosts) are reported as
+// unavailable instead of failing the run. A group the kernel only scheduled for part of the region
+// (multiplexed) is scaled up to the whole of it, one it never scheduled is reported as unavailable.
+// On other platforms every counter is unavailable.
+namespace bench {
+    namespace perf {
+        enum class counter : uint8_t {
+            cycles,
+            instructions,
+            branch_misses,
+            l1d_misses,
+            llc_misses,
+            page_faults,
+            count
+        };
+        constexpr const size_t counter_count = static_cast<size_t>(counter::count);
+
+        constexpr const char *counter_name(counter c) noexcept {
+            switch (c) {
+            case counter::cycles:
+                return "cycles";
+            case counter::instructions:
+                return "instructions";
+            case counter::branch_misses:
+                return "branch_misses";
+            case counter::l1d_misses:
+                return "l1d_misses";
+            case counter::llc_misses:
+                return "llc_misses";
+            case counter::page_faults:
+                return "page_faults";
+            default:
+                return "unknown";
+            }
+        }
+
+        struct sample {
+            std::array<uint64_t, counter_count> values = {};
+            std::array<bool, counter_count>     valid  = {};
+            // some sample summed in was never scheduled on the PMU, so the totals undercount
+            bool unscheduled = false;
+
+            [[nodiscard]] bool has(counter c) const noexcept {
+                return valid[static_cast<size_t>(c)] && !unscheduled;
+            }
+            [[nodiscard]] uint64_t operator[](counter c) const noexcept {
+                return values[static_cast<size_t>(c)];
+            }
+            sample &operator+=(const sample &other) noexcept {
+                for (size_t i = 0; i < counter_count; i++) {
+                    values[i] += other.values[i];
+                    valid[i] = valid[i] || other.valid[i];
+                }
+                unscheduled = unscheduled || other.unscheduled;
+                return *this;
+            }
+        };
+
+        class counter_group {
+#if defined(__linux__)
+            std::array<int, counter_count>      _fds    = {};
+            std::array<uint64_t, counter_count> _ids    = {};
+            int                                 _leader = -1;
+
+            static int open_event(uint32_t type, uint64_t config, int group_fd) noexcept {
+                perf_event_attr attr = {};
+                attr.size            = sizeof(attr);
+                attr.type            = type;
+                attr.config          = config;
+                attr.disabled        = group_fd == -1 ? 1 : 0;
+                attr.exclude_kernel  = type == PERF_TYPE_SOFTWARE ? 0 : 1;
+                attr.exclude_hv      = 1;
+                attr.read_format     = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+                return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+            }
+
+            static constexpr uint64_t cache_config(uint64_t cache) noexcept {
+                return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            }
+
+          public:
+            counter_group() noexcept {
+                struct event {
+                    uint32_t type;
+                    uint64_t config;
+                };
+                constexpr std::array<event, counter_count> events = {{
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+                    {PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_L1D)},
+                    {PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_LL)},
+                    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+                }};
+                _fds.fill(-1);
+                for (size_t i = 0; i < counter_count; i++) {
+                    _fds[i] = open_event(events[i].type, events[i].config, _leader);
+                    if (_fds[i] == -1 || ::ioctl(_fds[i], PERF_EVENT_IOC_ID, &_ids[i]) != 0)
+                        _ids[i] = ~uint64_t{0};
+                    else if (_leader == -1)
+                        _leader = _fds[i];
+                }
+            }
+            counter_group(const counter_group &)            = delete;
+            counter_group &operator=(const counter_group &) = delete;
+            ~counter_group() {
+                for (int fd : _fds)
+                    if (fd != -1)
+                        ::close(fd);
+            }
+
+            [[nodiscard]] bool available() const noexcept {
+                return _leader != -1;
+            }
+
+            void start() noexcept {
+                if (_leader == -1)
+                    return;
+                ::ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ::ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+
+            sample stop() noexcept {
+                sample s;
+                if (_leader == -1)
+                    return s;
+                ::ioctl(_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+                // PERF_FORMAT_GROUP | PERF_FORMAT_ID | TOTAL_TIME_*: nr, time_enabled, time_running,
+                // then {value, id} per member
+                std::array<uint64_t, 3 + 2 * counter_count> buf = {};
+                if (::read(_leader, buf.data(), sizeof(buf)) <= 0)
+                    return s;
+                // never scheduled (PMU taken by someone else), the zeros are not measurements
+                if (buf[2] == 0) {
+                    s.unscheduled = true;
+                    return s;
+                }
+
+                // multiplexed for part of the region, extrapolate to the whole of it as perf stat does
+                const uint64_t enabled = buf[1], running = buf[2];
+                auto           scaled  = [&](uint64_t value) noexcept {
+                    if (running >= enabled)
+                        return value;
+                    return static_cast<uint64_t>((double)value * (double)enabled / (double)running);
+                };
+
+                const size_t nr = (std::min)(static_cast<size_t>(buf[0]), counter_count);
+                for (size_t j = 0; j < nr; j++) {
+                    for (size_t i = 0; i < counter_count; i++) {
+                        if (_fds[i] != -1 && _ids[i] == buf[4 + 2 * j]) {
+                            s.values[i] = scaled(buf[3 + 2 * j]);
+                            s.valid[i]  = true;
+                        }
+                    }
+                }
+                return s;
+            }
+#else
+          public:
+            [[nodiscard]] bool available() const noexcept {
+                return false;
+            }
+            void start() noexcept {};
+            sample stop() noexcept {
+                return {};
+            }
+#endif
+        };
+    } // namespace perf
+} // namespace bench
@@ -0,0 +1,666 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86) && !defined(_M_ARM64EC))
+#define INLINE_VECTOR_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// kernels are compiled for their instruction set regardless of the build flags and only called
+// after the cpu was probed, msvc needs no attribute to emit the intrinsics
+#if defined(INLINE_VECTOR_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define INLINE_VECTOR_TARGET(isa) __attribute__((target(isa)))
+#else
+#define INLINE_VECTOR_TARGET(isa)
+#endif
+
+namespace inline_vector {
+    namespace details {
+        enum class simd_level : uint8_t { scalar, sse2, avx2, avx512 };
+
+        // widest instruction set supported by both the cpu and the os (saved register state)
+        inline simd_level detect_simd_level() noexcept {
+#if defined(INLINE_VECTOR_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+                return simd_level::avx512;
+            if (__builtin_cpu_supports("avx2"))
+                return simd_level::avx2;
+            if (__builtin_cpu_supports("sse2"))
+                return simd_level::sse2;
+#elif defined(INLINE_VECTOR_SIMD_X86) && defined(_MSC_VER)
+            int regs[4];
+            __cpuid(regs, 0);
+            const int max_leaf = regs[0];
+            __cpuid(regs, 1);
+            const bool               sse2    = (regs[3] >> 26) & 1;
+            const bool               osxsave = (regs[2] >> 27) & 1;
+            const unsigned long long xcr0    = osxsave ? _xgetbv(0) : 0;
+            if (max_leaf >= 7) {
+                __cpuidex(regs, 7, 0);
+                if ((xcr0 & 0xe6) == 0xe6 && ((regs[1] >> 16) & 1) && ((regs[1] >> 30) & 1))
+                    return simd_level::avx512;
+                if ((xcr0 & 0x6) == 0x6 && ((regs[1] >> 5) & 1))
+                    return simd_level::avx2;
+            }
+            if (sse2)
+                return simd_level::sse2;
+#endif
+            return simd_level::scalar;
+        }
+        inline ::std::atomic<simd_level> &active_simd_level() noexcept {
+            static ::std::atomic<simd_level> level{detect_simd_level()};
+            return level;
+        }
+
+        // element types the kernels handle, everything else goes to the std algorithms
+        template <typename T>
+        concept simd_element = ::std::is_arithmetic_v<T> && !::std::is_same_v<T, bool> &&
+                               (::std::is_integral_v<T> ? (sizeof(T) == 1 || sizeof(T) == 2 ||
+                                                           sizeof(T) == 4 || sizeof(T) == 8)
+                                                        : (sizeof(T) == 4 || sizeof(T) == 8));
+
+        // min or max by operator<, ignores NaNs after the first element like std::min/max_element
+        template <bool Max, typename T> constexpr T pick(T best, T x) noexcept {
+            if constexpr (Max)
+                return best < x ? x : best;
+            else
+                return x < best ? x : best;
+        }
+
+#if defined(INLINE_VECTOR_SIMD_X86)
+        // 16 byte kernels, compare masks carry sizeof(T) bits per element
+        struct sse2_kernels {
+            using vec                           = __m128i;
+            static constexpr const size_t width = 16;
+
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("sse2") static vec load(const T *p) noexcept {
+                return _mm_loadu_si128(reinterpret_cast<const vec *>(p));
+            }
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("sse2")
+            static vec set1(T v) noexcept {
+                if constexpr (::std::is_same_v<T, float>)
+                    return _mm_castps_si128(_mm_set1_ps(v));
+                else if constexpr (::std::is_same_v<T, double>)
+                    return _mm_castpd_si128(_mm_set1_pd(v));
+                else if constexpr (sizeof(T) == 1)
+                    return _mm_set1_epi8(static_cast<char>(v));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_set1_epi16(static_cast<short>(v));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm_set1_epi32(static_cast<int>(v));
+                else
+                    return _mm_set1_epi64x(static_cast<long long>(v));
+            }
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("sse2")
+            static vec eq(vec a, vec b) noexcept {
+                vec m;
+                if constexpr (::std::is_same_v<T, float>)
+                    m = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+                else if constexpr (::std::is_same_v<T, double>)
+                    m = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+                else if constexpr (sizeof(T) == 1)
+                    m = _mm_cmpeq_epi8(a, b);
+                else if constexpr (sizeof(T) == 2)
+                    m = _mm_cmpeq_epi16(a, b);
+                else if constexpr (sizeof(T) == 4)
+                    m = _mm_cmpeq_epi32(a, b);
+                else { // no 64 bit compare before sse4.1, both halves must match
+                    m = _mm_cmpeq_epi32(a, b);
+                    m = _mm_and_si128(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+                }
+                return m;
+            }
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("sse2")
+            static uint32_t eq_mask(vec a, vec b) noexcept {
+                return static_cast<uint32_t>(_mm_movemask_epi8(eq<T>(a, b)));
+            }
+            // lane wise min/max of x and acc, a NaN x keeps acc
+            template <bool Max, typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("sse2") static vec pick(vec x, vec acc) noexcept {
+                if constexpr (::std::is_same_v<T, float>) {
+                    __m128 a = _mm_castsi128_ps(x), b = _mm_castsi128_ps(acc);
+                    return _mm_castps_si128(Max ? _mm_max_ps(a, b) : _mm_min_ps(a, b));
+                } else if constexpr (::std::is_same_v<T, double>) {
+                    __m128d a = _mm_castsi128_pd(x), b = _mm_castsi128_pd(acc);
+                    return _mm_castpd_si128(Max ? _mm_max_pd(a, b) : _mm_min_pd(a, b));
+                } else if constexpr (sizeof(T) == 1) { // only unsigned bytes, flip the sign for signed
+                    const vec flip = _mm_set1_epi8(::std::is_signed_v<T> ? char(0x80) : 0);
+                    vec       a = _mm_xor_si128(x, flip), b = _mm_xor_si128(acc, flip);
+                    return _mm_xor_si128(Max ? _mm_max_epu8(a, b) : _mm_min_epu8(a, b), flip);
+                } else if constexpr (sizeof(T) == 2) { // only signed shorts, flip the sign for unsigned
+                    const vec flip = _mm_set1_epi16(::std::is_signed_v<T> ? 0 : short(0x8000));
+                    vec       a = _mm_xor_si128(x, flip), b = _mm_xor_si128(acc, flip);
+                    return _mm_xor_si128(Max ? _mm_max_epi16(a, b) : _mm_min_epi16(a, b), flip);
+                } else {
+                    static_assert(sizeof(T) == 4, "no 64 bit integer compare in sse2");
+                    const vec flip = _mm_set1_epi32(::std::is_signed_v<T> ? 0 : int(0x80000000));
+                    vec       gt   = _mm_cmpgt_epi32(_mm_xor_si128(x, flip), _mm_xor_si128(acc, flip));
+                    if constexpr (!Max)
+                        gt = _mm_xor_si128(gt, _mm_set1_epi32(-1));
+                    return _mm_or_si128(_mm_and_si128(gt, x), _mm_andnot_si128(gt, acc));
+                }
+            }
+
+            // first index i where (p[i] == v) == equal, or n, requires n >= lanes
+            template <typename T>
+            INLINE_VECTOR_TARGET("sse2") static size_t find(const T *p, size_t n, T v, bool equal) noexcept {
+                constexpr size_t lanes  = width / sizeof(T);
+                const vec        needle = set1(v);
+                const uint32_t   flip   = equal ? 0 : 0xffff;
+                size_t           i      = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    if (uint32_t m = eq_mask<T>(load(p + i), needle) ^ flip)
+                        return i + ::std::countr_zero(m) / sizeof(T);
+                }
+                if (i < n) { // overlap the last full vector, its head was already rejected
+                    if (uint32_t m = eq_mask<T>(load(p + n - lanes), needle) ^ flip)
+                        return n - lanes + ::std::countr_zero(m) / sizeof(T);
+                }
+                return n;
+            }
+            // matching bytes are counted in byte lanes (no popcnt in sse2), folded every 255 vectors
+            template <typename T>
+            INLINE_VECTOR_TARGET("sse2")
+            static size_t count(const T *p, size_t n, T v) noexcept {
+                constexpr size_t lanes  = width / sizeof(T);
+                const vec        needle = set1(v);
+                vec              total  = _mm_setzero_si128();
+                size_t           i      = 0;
+                while (i + lanes <= n) {
+                    vec bytes = _mm_setzero_si128();
+                    for (size_t k = 0; k < 255 && i + lanes <= n; k++, i += lanes)
+                        bytes = _mm_sub_epi8(bytes, eq<T>(load(p + i), needle));
+                    total = _mm_add_epi64(total, _mm_sad_epu8(bytes, _mm_setzero_si128()));
+                }
+                alignas(width) uint64_t sums[2];
+                _mm_store_si128(reinterpret_cast<vec *>(sums), total);
+                size_t found = static_cast<size_t>((sums[0] + sums[1]) / sizeof(T));
+                for (; i < n; i++)
+                    found += p[i] == v;
+                return found;
+            }
+            // min/max value, requires n >= lanes and p[0] not NaN
+            template <bool Max, typename T>
+            INLINE_VECTOR_TARGET("sse2") static T reduce(const T *p, size_t n) noexcept {
+                constexpr size_t lanes = width / sizeof(T);
+                T                best  = p[0];
+                if constexpr (::std::is_integral_v<T> && sizeof(T) == 8) {
+                    for (size_t i = 1; i < n; i++)
+                        best = ::inline_vector::details::pick<Max>(best, p[i]);
+                } else {
+                    // independent accumulators so the compare chains overlap
+                    vec    acc = set1(best), acc1 = acc, acc2 = acc, acc3 = acc;
+                    size_t i   = 0;
+                    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+                        acc  = pick<Max, T>(load(p + i), acc);
+                        acc1 = pick<Max, T>(load(p + i + lanes), acc1);
+                        acc2 = pick<Max, T>(load(p + i + 2 * lanes), acc2);
+                        acc3 = pick<Max, T>(load(p + i + 3 * lanes), acc3);
+                    }
+                    for (; i + lanes <= n; i += lanes)
+                        acc = pick<Max, T>(load(p + i), acc);
+                    acc = pick<Max, T>(load(p + n - lanes), acc);
+                    acc = pick<Max, T>(pick<Max, T>(acc1, acc), pick<Max, T>(acc3, acc2));
+                    alignas(width) T lane[lanes];
+                    _mm_store_si128(reinterpret_cast<vec *>(lane), acc);
+                    for (size_t k = 0; k < lanes; k++)
+                        best = ::inline_vector::details::pick<Max>(best, lane[k]);
+                }
+                return best;
+            }
+        };
+
+        // 32 byte kernels, compare masks carry sizeof(T) bits per element
+        struct avx2_kernels {
+            using vec                           = __m256i;
+            static constexpr const size_t width = 32;
+
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx2") static vec load(const T *p) noexcept {
+                return _mm256_loadu_si256(reinterpret_cast<const vec *>(p));
+            }
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx2")
+            static vec set1(T v) noexcept {
+                if constexpr (::std::is_same_v<T, float>)
+                    return _mm256_castps_si256(_mm256_set1_ps(v));
+                else if constexpr (::std::is_same_v<T, double>)
+                    return _mm256_castpd_si256(_mm256_set1_pd(v));
+                else if constexpr (sizeof(T) == 1)
+                    return _mm256_set1_epi8(static_cast<char>(v));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm256_set1_epi16(static_cast<short>(v));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm256_set1_epi32(static_cast<int>(v));
+                else
+                    return _mm256_set1_epi64x(static_cast<long long>(v));
+            }
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx2")
+            static uint32_t eq_mask(vec a, vec b) noexcept {
+                vec m;
+                if constexpr (::std::is_same_v<T, float>)
+                    m = _mm256_castps_si256(
+                        _mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+                else if constexpr (::std::is_same_v<T, double>)
+                    m = _mm256_castpd_si256(
+                        _mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+                else if constexpr (sizeof(T) == 1)
+                    m = _mm256_cmpeq_epi8(a, b);
+                else if constexpr (sizeof(T) == 2)
+                    m = _mm256_cmpeq_epi16(a, b);
+                else if constexpr (sizeof(T) == 4)
+                    m = _mm256_cmpeq_epi32(a, b);
+                else
+                    m = _mm256_cmpeq_epi64(a, b);
+                return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+            }
+            // lane wise min/max of x and acc, a NaN x keeps acc
+            template <bool Max, typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx2") static vec pick(vec x, vec acc) noexcept {
+                if constexpr (::std::is_same_v<T, float>) {
+                    __m256 a = _mm256_castsi256_ps(x), b = _mm256_castsi256_ps(acc);
+                    return _mm256_castps_si256(Max ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b));
+                } else if constexpr (::std::is_same_v<T, double>) {
+                    __m256d a = _mm256_castsi256_pd(x), b = _mm256_castsi256_pd(acc);
+                    return _mm256_castpd_si256(Max ? _mm256_max_pd(a, b) : _mm256_min_pd(a, b));
+                } else if constexpr (sizeof(T) == 1) {
+                    if constexpr (::std::is_signed_v<T>)
+                        return Max ? _mm256_max_epi8(x, acc) : _mm256_min_epi8(x, acc);
+                    else
+                        return Max ? _mm256_max_epu8(x, acc) : _mm256_min_epu8(x, acc);
+                } else if constexpr (sizeof(T) == 2) {
+                    if constexpr (::std::is_signed_v<T>)
+                        return Max ? _mm256_max_epi16(x, acc) : _mm256_min_epi16(x, acc);
+                    else
+                        return Max ? _mm256_max_epu16(x, acc) : _mm256_min_epu16(x, acc);
+                } else if constexpr (sizeof(T) == 4) {
+                    if constexpr (::std::is_signed_v<T>)
+                        return Max ? _mm256_max_epi32(x, acc) : _mm256_min_epi32(x, acc);
+                    else
+                        return Max ? _mm256_max_epu32(x, acc) : _mm256_min_epu32(x, acc);
+                } else { // no 64 bit min/max before avx-512, compare and blend
+                    const vec flip = _mm256_set1_epi64x(::std::is_signed_v<T> ? 0 : INT64_MIN);
+                    vec gt = _mm256_cmpgt_epi64(_mm256_xor_si256(x, flip), _mm256_xor_si256(acc, flip));
+                    return Max ? _mm256_blendv_epi8(acc, x, gt) : _mm256_blendv_epi8(x, acc, gt);
+                }
+            }
+
+            // first index i where (p[i] == v) == equal, or n, requires n >= lanes
+            template <typename T>
+            INLINE_VECTOR_TARGET("avx2") static size_t find(const T *p, size_t n, T v, bool equal) noexcept {
+                constexpr size_t lanes  = width / sizeof(T);
+                const vec        needle = set1(v);
+                const uint32_t   flip   = equal ? 0 : 0xffffffffu;
+                size_t           i      = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    if (uint32_t m = eq_mask<T>(load(p + i), needle) ^ flip)
+                        return i + ::std::countr_zero(m) / sizeof(T);
+                }
+                if (i < n) { // overlap the last full vector, its head was already rejected
+                    if (uint32_t m = eq_mask<T>(load(p + n - lanes), needle) ^ flip)
+                        return n - lanes + ::std::countr_zero(m) / sizeof(T);
+                }
+                return n;
+            }
+            template <typename T>
+            INLINE_VECTOR_TARGET("avx2")
+            static size_t count(const T *p, size_t n, T v) noexcept {
+                constexpr size_t lanes  = width / sizeof(T);
+                const vec        needle = set1(v);
+                size_t           bits   = 0;
+                size_t           i      = 0;
+                for (; i + lanes <= n; i += lanes)
+                    bits += ::std::popcount(eq_mask<T>(load(p + i), needle));
+                size_t found = bits / sizeof(T);
+                for (; i < n; i++)
+                    found += p[i] == v;
+                return found;
+            }
+            // min/max value, requires n >= lanes and p[0] not NaN
+            template <bool Max, typename T>
+            INLINE_VECTOR_TARGET("avx2") static T reduce(const T *p, size_t n) noexcept {
+                constexpr size_t lanes = width / sizeof(T);
+                T                best  = p[0];
+                // independent accumulators so the compare chains overlap
+                vec    acc = set1(best), acc1 = acc, acc2 = acc, acc3 = acc;
+                size_t i   = 0;
+                for (; i + 4 * lanes <= n; i += 4 * lanes) {
+                    acc  = pick<Max, T>(load(p + i), acc);
+                    acc1 = pick<Max, T>(load(p + i + lanes), acc1);
+                    acc2 = pick<Max, T>(load(p + i + 2 * lanes), acc2);
+                    acc3 = pick<Max, T>(load(p + i + 3 * lanes), acc3);
+                }
+                for (; i + lanes <= n; i += lanes)
+                    acc = pick<Max, T>(load(p + i), acc);
+                acc = pick<Max, T>(load(p + n - lanes), acc);
+                acc = pick<Max, T>(pick<Max, T>(acc1, acc), pick<Max, T>(acc3, acc2));
+                alignas(width) T lane[lanes];
+                _mm256_store_si256(reinterpret_cast<vec *>(lane), acc);
+                for (size_t k = 0; k < lanes; k++)
+                    best = ::inline_vector::details::pick<Max>(best, lane[k]);
+                return best;
+            }
+        };
+
+        // 64 byte kernels (avx-512 f + bw), compare masks carry one bit per element
+        struct avx512_kernels {
+            using vec                           = __m512i;
+            static constexpr const size_t width = 64;
+
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx512f,avx512bw")
+            static vec load(const T *p) noexcept {
+                return _mm512_loadu_si512(reinterpret_cast<const void *>(p));
+            }
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx512f,avx512bw") static vec set1(T v) noexcept {
+                if constexpr (::std::is_same_v<T, float>)
+                    return _mm512_castps_si512(_mm512_set1_ps(v));
+                else if constexpr (::std::is_same_v<T, double>)
+                    return _mm512_castpd_si512(_mm512_set1_pd(v));
+                else if constexpr (sizeof(T) == 1)
+                    return _mm512_set1_epi8(static_cast<char>(v));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm512_set1_epi16(static_cast<short>(v));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm512_set1_epi32(static_cast<int>(v));
+                else
+                    return _mm512_set1_epi64(static_cast<long long>(v));
+            }
+            template <typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx512f,avx512bw")
+            static uint64_t eq_mask(vec a, vec b) noexcept {
+                if constexpr (::std::is_same_v<T, float>)
+                    return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_EQ_OQ);
+                else if constexpr (::std::is_same_v<T, double>)
+                    return _mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_EQ_OQ);
+                else if constexpr (sizeof(T) == 1)
+                    return _mm512_cmpeq_epi8_mask(a, b);
+                else if constexpr (sizeof(T) == 2)
+                    return _mm512_cmpeq_epi16_mask(a, b);
+                else if constexpr (sizeof(T) == 4)
+                    return _mm512_cmpeq_epi32_mask(a, b);
+                else
+                    return _mm512_cmpeq_epi64_mask(a, b);
+            }
+            // lane wise min/max of x and acc, a NaN x keeps acc. Compare and masked move rather than
+            // the min/max intrinsics, which trip -Wuninitialized in gcc's headers
+            template <bool Max, typename T>
+            INLINE_VECTOR_FORCEINLINE INLINE_VECTOR_TARGET("avx512f,avx512bw")
+            static vec pick(vec x, vec acc) noexcept {
+                constexpr int order = Max ? _MM_CMPINT_NLE : _MM_CMPINT_LT;
+                if constexpr (::std::is_same_v<T, float>)
+                    return _mm512_mask_mov_epi32(
+                        acc, _mm512_cmp_ps_mask(_mm512_castsi512_ps(x), _mm512_castsi512_ps(acc),
+                                                Max ? _CMP_GT_OQ : _CMP_LT_OQ),
+                        x);
+                else if constexpr (::std::is_same_v<T, double>)
+                    return _mm512_mask_mov_epi64(
+                        acc, _mm512_cmp_pd_mask(_mm512_castsi512_pd(x), _mm512_castsi512_pd(acc),
+                                                Max ? _CMP_GT_OQ : _CMP_LT_OQ),
+                        x);
+                else if constexpr (sizeof(T) == 1)
+                    return _mm512_mask_mov_epi8(acc,
+                                                ::std::is_signed_v<T> ? _mm512_cmp_epi8_mask(x, acc, order)
+                                                                      : _mm512_cmp_epu8_mask(x, acc, order),
+                                                x);
+                else if constexpr (sizeof(T) == 2)
+                    return _mm512_mask_mov_epi16(acc,
+                                                 ::std::is_signed_v<T> ? _mm512_cmp_epi16_mask(x, acc, order)
+                                                                       : _mm512_cmp_epu16_mask(x, acc, order),
+                                                 x);
+                else if constexpr (sizeof(T) == 4)
+                    return _mm512_mask_mov_epi32(acc,
+                                                 ::std::is_signed_v<T> ? _mm512_cmp_epi32_mask(x, acc, order)
+                                                                       : _mm512_cmp_epu32_mask(x, acc, order),
+                                                 x);
+                else
+                    return _mm512_mask_mov_epi64(acc,
+                                                 ::std::is_signed_v<T> ? _mm512_cmp_epi64_mask(x, acc, order)
+                                                                       : _mm512_cmp_epu64_mask(x, acc, order),
+                                                 x);
+            }
+
+            // first index i where (p[i] == v) == equal, or n, requires n >= lanes
+            template <typename T>
+            INLINE_VECTOR_TARGET("avx512f,avx512bw")
+            static size_t find(const T *p, size_t n, T v, bool equal) noexcept {
+                constexpr size_t   lanes  = width / sizeof(T);
+                constexpr uint64_t all    = lanes == 64 ? ~uint64_t{0} : (uint64_t{1} << lanes) - 1;
+                const vec          needle = set1(v);
+                const uint64_t     flip   = equal ? 0 : all;
+                size_t             i      = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    if (uint64_t m = eq_mask<T>(load(p + i), needle) ^ flip)
+                        return i + ::std::countr_zero(m);
+                }
+                if (i < n) { // overlap the last full vector, its head was already rejected
+                    if (uint64_t m = eq_mask<T>(load(p + n - lanes), needle) ^ flip)
+                        return n - lanes + ::std::countr_zero(m);
+                }
+                return n;
+            }
+            template <typename T>
+            INLINE_VECTOR_TARGET("avx512f,avx512bw")
+            static size_t count(const T *p, size_t n, T v) noexcept {
+                constexpr size_t lanes  = width / sizeof(T);
+                const vec        needle = set1(v);
+                size_t           found  = 0;
+                size_t           i      = 0;
+                for (; i + lanes <= n; i += lanes)
+                    found += ::std::popcount(eq_mask<T>(load(p + i), needle));
+                for (; i < n; i++)
+                    found += p[i] == v;
+                return found;
+            }
+            // min/max value, requires n >= lanes and p[0] not NaN
+            template <bool Max, typename T>
+            INLINE_VECTOR_TARGET("avx512f,avx512bw")
+            static T reduce(const T *p, size_t n) noexcept {
+                constexpr size_t lanes = width / sizeof(T);
+                T                best  = p[0];
+                // independent accumulators so the compare chains overlap
+                vec    acc = set1(best), acc1 = acc, acc2 = acc, acc3 = acc;
+                size_t i   = 0;
+                for (; i + 4 * lanes <= n; i += 4 * lanes) {
+                    acc  = pick<Max, T>(load(p + i), acc);
+                    acc1 = pick<Max, T>(load(p + i + lanes), acc1);
+                    acc2 = pick<Max, T>(load(p + i + 2 * lanes), acc2);
+                    acc3 = pick<Max, T>(load(p + i + 3 * lanes), acc3);
+                }
+                for (; i + lanes <= n; i += lanes)
+                    acc = pick<Max, T>(load(p + i), acc);
+                acc = pick<Max, T>(load(p + n - lanes), acc);
+                acc = pick<Max, T>(pick<Max, T>(acc1, acc), pick<Max, T>(acc3, acc2));
+                alignas(width) T lane[lanes];
+                _mm512_store_si512(reinterpret_cast<void *>(lane), acc);
+                for (size_t k = 0; k < lanes; k++)
+                    best = ::inline_vector::details::pick<Max>(best, lane[k]);
+                return best;
+            }
+        };
+#endif
+
+        // dispatch to the widest kernel the cpu supports whose vector fits in n elements
+        template <simd_element T> size_t simd_find(const T *p, size_t n, T v, bool equal) noexcept {
+#if defined(INLINE_VECTOR_SIMD_X86)
+            switch (active_simd_level().load(::std::memory_order_relaxed)) {
+            case simd_level::avx512:
+                if (n >= avx512_kernels::width / sizeof(T))
+                    return avx512_kernels::find(p, n, v, equal);
+                [[fallthrough]];
+            case simd_level::avx2:
+                if (n >= avx2_kernels::width / sizeof(T))
+                    return avx2_kernels::find(p, n, v, equal);
+                [[fallthrough]];
+            case simd_level::sse2:
+                if (n >= sse2_kernels::width / sizeof(T))
+                    return sse2_kernels::find(p, n, v, equal);
+                [[fallthrough]];
+            default:
+                break;
+            }
+#endif
+            for (size_t i = 0; i < n; i++)
+                if ((p[i] == v) == equal)
+                    return i;
+            return n;
+        }
+        template <simd_element T> size_t simd_count(const T *p, size_t n, T v) noexcept {
+#if defined(INLINE_VECTOR_SIMD_X86)
+            switch (active_simd_level().load(::std::memory_order_relaxed)) {
+            case simd_level::avx512:
+                if (n >= avx512_kernels::width / sizeof(T))
+                    return avx512_kernels::count(p, n, v);
+                [[fallthrough]];
+            case simd_level::avx2:
+                if (n >= avx2_kernels::width / sizeof(T))
+                    return avx2_kernels::count(p, n, v);
+                [[fallthrough]];
+            case simd_level::sse2:
+                if (n >= sse2_kernels::width / sizeof(T))
+                    return sse2_kernels::count(p, n, v);
+                [[fallthrough]];
+            default:
+                break;
+            }
+#endif
+            size_t found = 0;
+            for (size_t i = 0; i < n; i++)
+                found += p[i] == v;
+            return found;
+        }
+        // index of the first min (max) element, the extreme value is reduced with simd and then found
+        template <bool Max, simd_element T> size_t simd_extreme(const T *p, size_t n) noexcept {
+            if (n == 0)
+                return 0;
+            if constexpr (::std::is_floating_point_v<T>) {
+                if (p[0] != p[0]) // nothing compares less than a leading NaN
+                    return 0;
+            }
+            T best = p[0];
+#if defined(INLINE_VECTOR_SIMD_X86)
+            switch (active_simd_level().load(::std::memory_order_relaxed)) {
+            case simd_level::avx512:
+                if (n >= avx512_kernels::width / sizeof(T)) {
+                    best = avx512_kernels::reduce<Max>(p, n);
+                    break;
+                }
+                [[fallthrough]];
+            case simd_level::avx2:
+                if (n >= avx2_kernels::width / sizeof(T)) {
+                    best = avx2_kernels::reduce<Max>(p, n);
+                    break;
+                }
+                [[fallthrough]];
+            case simd_level::sse2:
+                if (n >= sse2_kernels::width / sizeof(T)) {
+                    best = sse2_kernels::reduce<Max>(p, n);
+                    break;
+                }
+                [[fallthrough]];
+            default:
+                for (size_t i = 1; i < n; i++)
+                    best = ::inline_vector::details::pick<Max>(best, p[i]);
+                break;
+            }
+#else
+            for (size_t i = 1; i < n; i++)
+                best = ::inline_vector::details::pick<Max>(best, p[i]);
+#endif
+            return ::inline_vector::details::simd_find(p, n, best, true);
+        }
+    }; // namespace details
+
+    // vectorized linear searches over any contiguous vector (inline_vector, static_vector,
+    // small_vector, ...), arithmetic elements use sse2/avx2/avx-512 kernels picked at runtime,
+    // other element types fall back to the std algorithms. Results match the std algorithms.
+    namespace simd {
+        using level = ::inline_vector::details::simd_level;
+
+        [[nodiscard]] inline level active_level() noexcept {
+            return ::inline_vector::details::active_simd_level().load(::std::memory_order_relaxed);
+        }
+        // caps the kernels used from now on (eg to compare them), never above what the cpu supports
+        inline void limit_level(level max) noexcept {
+            const level detected = ::inline_vector::details::detect_simd_level();
+            ::inline_vector::details::active_simd_level().store(max < detected ? max : detected,
+                                                                ::std::memory_order_relaxed);
+        }
+
+        template <typename Vec>
+        concept contiguous_vector = requires(Vec &v) {
+            typename ::std::remove_cv_t<Vec>::value_type;
+            v.data();
+            v.size();
+            v.begin();
+            v.end();
+        };
+        template <typename Vec> using value_of = typename ::std::remove_cv_t<Vec>::value_type;
+
+        // find
+        template <contiguous_vector Vec> [[nodiscard]] auto find(Vec &v, const value_of<Vec> &value) {
+            if constexpr (::inline_vector::details::simd_element<value_of<Vec>>)
+                return v.begin() +
+                       ::inline_vector::details::simd_find<value_of<Vec>>(v.data(), v.size(), value, true);
+            else
+                return ::std::find(v.begin(), v.end(), value);
+        }
+        // find_first_not, first element != value
+        template <contiguous_vector Vec>
+        [[nodiscard]] auto find_first_not(Vec &v, const value_of<Vec> &value) {
+            if constexpr (::inline_vector::details::simd_element<value_of<Vec>>)
+                return v.begin() +
+                       ::inline_vector::details::simd_find<value_of<Vec>>(v.data(), v.size(), value, false);
+            else
+                return ::std::find_if(v.begin(), v.end(), [&](const auto &x) { return !(x == value); });
+        }
+        // index_of, v.size() when absent
+        template <contiguous_vector Vec>
+        [[nodiscard]] ::std::size_t index_of(const Vec &v, const value_of<Vec> &value) {
+            return static_cast<::std::size_t>(::inline_vector::simd::find(v, value) - v.begin());
+        }
+        // contains
+        template <contiguous_vector Vec>
+        [[nodiscard]] bool contains(const Vec &v, const value_of<Vec> &value) {
+            return ::inline_vector::simd::find(v, value) != v.end();
+        }
+        // count
+        template <contiguous_vector Vec>
+        [[nodiscard]] ::std::size_t count(const Vec &v, const value_of<Vec> &value) {
+            if constexpr (::inline_vector::details::simd_element<value_of<Vec>>)
+                return ::inline_vector::details::simd_count<value_of<Vec>>(v.data(), v.size(), value);
+            else
+                return static_cast<::std::size_t>(::std::count(v.begin(), v.end(), value));
+        }
+        // min_element / max_element, the first of equal extremes, end() when empty
+        template <contiguous_vector Vec> [[nodiscard]] auto min_element(Vec &v) {
+            if constexpr (::inline_vector::details::simd_element<value_of<Vec>>)
+                return v.begin() +
+                       ::inline_vector::details::simd_extreme<false, value_of<Vec>>(v.data(), v.size());
+            else
+                return ::std::min_element(v.begin(), v.end());
+        }
+        template <contiguous_vector Vec> [[nodiscard]] auto max_element(Vec &v) {
+            if constexpr (::inline_vector::details::simd_element<value_of<Vec>>)
+                return v.begin() +
+                       ::inline_vector::details::simd_extreme<true, value_of<Vec>>(v.data(), v.size());
+            else
+                return ::std::max_element(v.begin(), v.end());
+        }
+    }; // namespace simd
+} // namespace inline_vector
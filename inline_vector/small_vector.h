@@ -0,0 +1,461 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <cstddef>
+
+namespace inline_vector {
+    // vector with room for N elements inside the object, once that fills up the elements are
+    // relocated into a buffer from Alloc which then grows geometrically. The elements are always
+    // tracked by an inline_vector (_vec) pointing at whichever buffer is live, so everything that
+    // doesn't need more room is forwarded to it unchanged. Allocators must compare equal or
+    // propagate, buffers are handed between small_vectors on move and swap.
+    template <typename T, ::std::size_t N, typename Alloc = ::std::allocator<T>> struct small_vector {
+        static_assert(N > 0, "small_vector requires a non zero inline capacity");
+
+        using element_type           = T;
+        using value_type             = typename ::std::remove_cv<T>::type;
+        using const_reference        = const value_type &;
+        using size_type              = ::std::size_t;
+        using difference_type        = ::std::ptrdiff_t;
+        using pointer                = element_type *;
+        using const_pointer          = const element_type *;
+        using reference              = element_type &;
+        using iterator               = pointer;
+        using const_iterator         = const_pointer;
+        using reverse_iterator       = ::std::reverse_iterator<iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+        using allocator_type         = Alloc;
+        using view_type              = ::inline_vector::inline_vector<T>;
+
+      private:
+        using alloc_traits = ::std::allocator_traits<Alloc>;
+
+        view_type                  _vec;
+        alignas(T)::std::byte      _storage[sizeof(T) * N];
+        [[no_unique_address]] Alloc _alloc;
+
+        [[nodiscard]] T *inline_data() noexcept {
+            return ::std::launder(reinterpret_cast<T *>(_storage));
+        }
+        [[nodiscard]] const T *inline_data() const noexcept {
+            return ::std::launder(reinterpret_cast<const T *>(_storage));
+        }
+        // points _vec at a buffer, never touches elements
+        void rebind(T *data, T *end, T *cap) noexcept {
+            _vec._data = data;
+            _vec._end  = end;
+            _vec._cap  = cap;
+        }
+        void reset_inline() noexcept {
+            rebind(inline_data(), inline_data(), inline_data() + N);
+        }
+        void release_heap() noexcept {
+            if (!is_inline())
+                alloc_traits::deallocate(_alloc, _vec._data, capacity());
+        }
+        [[nodiscard]] size_type grown_capacity(size_type required) const {
+            if (required > max_size())
+                throw ::std::length_error("small_vector cannot grow past max_size");
+            size_type doubled = capacity() > max_size() / 2 ? max_size() : capacity() * 2;
+            return (::std::max)(required, doubled);
+        }
+
+        // moves everything into a new buffer of new_cap elements, leaving a gap of count slots at idx
+        // which fill(T *) constructs in place, the old buffer stays valid until fill has run so fill
+        // may read from this vector
+        template <typename Fill>
+        iterator reallocate(size_type new_cap, size_type idx, size_type count, Fill &&fill) {
+            size_type old_size = size();
+            T        *buf      = alloc_traits::allocate(_alloc, new_cap);
+            try {
+                fill(buf + idx);
+            } catch (...) {
+                alloc_traits::deallocate(_alloc, buf, new_cap);
+                throw;
+            }
+            ::inline_vector::details::uninitialized_relocate_n(_vec._data, idx, buf);
+            ::inline_vector::details::uninitialized_relocate_n(_vec._data + idx, old_size - idx,
+                                                               buf + idx + count);
+            release_heap();
+            rebind(buf, buf + old_size + count, buf + new_cap);
+            return buf + idx;
+        }
+
+      public:
+        small_vector() noexcept(noexcept(Alloc())) : _alloc() {
+            reset_inline();
+        };
+        explicit small_vector(const Alloc &alloc) noexcept : _alloc(alloc) {
+            reset_inline();
+        };
+        small_vector(size_type count, const T &value, const Alloc &alloc = Alloc()) : _alloc(alloc) {
+            reset_inline();
+            assign(count, value);
+        };
+        template <::std::input_iterator It1>
+        small_vector(It1 first, It1 last, const Alloc &alloc = Alloc()) : _alloc(alloc) {
+            reset_inline();
+            assign(first, last);
+        };
+        small_vector(::std::initializer_list<T> ilist, const Alloc &alloc = Alloc()) : _alloc(alloc) {
+            reset_inline();
+            assign(ilist);
+        };
+        small_vector(const small_vector &other)
+            : _alloc(alloc_traits::select_on_container_copy_construction(other._alloc)) {
+            reset_inline();
+            reserve(other.size());
+            ::inline_vector::details::uninitialized_copy_n(other.data(), other.size(), _vec._data);
+            _vec._end = _vec._data + other.size();
+        };
+        small_vector(small_vector &&other) noexcept(::std::is_nothrow_move_constructible<T>::value)
+            : _alloc(::std::move(other._alloc)) {
+            if (other.is_inline()) {
+                reset_inline();
+                ::inline_vector::details::uninitialized_relocate_n(other._vec._data, other.size(),
+                                                                   _vec._data);
+                _vec._end = _vec._data + other.size();
+            } else {
+                // steal the heap buffer
+                rebind(other._vec._data, other._vec._end, other._vec._cap);
+            }
+            other.reset_inline();
+        };
+        ~small_vector() {
+            _vec.clear();
+            release_heap();
+        };
+
+        // is_inline (non standard), true while the elements live inside the object
+        [[nodiscard]] bool is_inline() const noexcept {
+            return _vec._data == inline_data();
+        };
+        [[nodiscard]] allocator_type get_allocator() const noexcept {
+            return _alloc;
+        };
+        // inline_capacity (non standard)
+        static constexpr size_type inline_capacity() noexcept {
+            return N;
+        };
+
+        // front
+        [[nodiscard]] reference front() {
+            return _vec.front();
+        };
+        [[nodiscard]] const_reference front() const {
+            return _vec.front();
+        };
+        // back's
+        [[nodiscard]] reference back() {
+            return _vec.back();
+        };
+        [[nodiscard]] const_reference back() const {
+            return _vec.back();
+        };
+        // data's
+        [[nodiscard]] T *data() noexcept {
+            return _vec.data();
+        };
+        [[nodiscard]] const T *data() const noexcept {
+            return _vec.data();
+        };
+        // begin's
+        [[nodiscard]] iterator begin() noexcept {
+            return _vec.begin();
+        };
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return _vec.begin();
+        };
+        [[nodiscard]] const_iterator cbegin() const noexcept {
+            return _vec.cbegin();
+        };
+        // rbegin's
+        [[nodiscard]] reverse_iterator rbegin() noexcept {
+            return _vec.rbegin();
+        };
+        [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+            return _vec.rbegin();
+        };
+        [[nodiscard]] const_reverse_iterator crbegin() const noexcept {
+            return _vec.crbegin();
+        };
+        // end's
+        [[nodiscard]] iterator end() noexcept {
+            return _vec.end();
+        };
+        [[nodiscard]] const_iterator end() const noexcept {
+            return _vec.end();
+        };
+        [[nodiscard]] const_iterator cend() const noexcept {
+            return _vec.cend();
+        };
+        // rend's
+        [[nodiscard]] reverse_iterator rend() noexcept {
+            return _vec.rend();
+        };
+        [[nodiscard]] const_reverse_iterator rend() const noexcept {
+            return _vec.rend();
+        };
+        [[nodiscard]] const_reverse_iterator crend() const noexcept {
+            return _vec.crend();
+        };
+        // empty's
+        [[nodiscard]] bool empty() const noexcept {
+            return _vec.empty();
+        };
+
+        // size
+        size_type size() const noexcept {
+            return _vec.size();
+        };
+        // capacity
+        size_type capacity() const noexcept {
+            return _vec.capacity();
+        };
+        // max_size
+        size_type max_size() const noexcept {
+            return (::std::min)(alloc_traits::max_size(_alloc), _vec.max_size());
+        };
+
+        void reserve(size_type new_cap) {
+            if (new_cap > capacity())
+                reallocate(new_cap, size(), 0, [](T *) {});
+        };
+        // moves back into the inline storage when the elements fit, otherwise into an exact fit buffer
+        void shrink_to_fit() {
+            if (is_inline() || size() == capacity())
+                return;
+            if (size() <= N) {
+                T        *heap     = _vec._data;
+                size_type heap_cap = capacity();
+                size_type count    = size();
+                ::inline_vector::details::uninitialized_relocate_n(heap, count, inline_data());
+                reset_inline();
+                _vec._end = _vec._data + count;
+                alloc_traits::deallocate(_alloc, heap, heap_cap);
+            } else {
+                size_type count = size();
+                T        *heap  = _vec._data;
+                size_type cap   = capacity();
+                T        *buf   = alloc_traits::allocate(_alloc, count);
+                ::inline_vector::details::uninitialized_relocate_n(heap, count, buf);
+                rebind(buf, buf + count, buf + count);
+                alloc_traits::deallocate(_alloc, heap, cap);
+            }
+        };
+
+        // assign's
+        void assign(size_type count, const T &value) {
+            if (count > capacity()) {
+                T tmp = value;
+                _vec.clear();
+                reserve(count);
+                _vec.assign(count, tmp);
+            } else {
+                _vec.assign(count, value);
+            }
+        };
+        template <::std::input_iterator It1> void assign(It1 first, It1 last) {
+            if constexpr (::std::forward_iterator<It1>) {
+                size_type count = ::std::distance(first, last);
+                if (count > capacity()) {
+                    _vec.clear();
+                    reserve(count);
+                }
+                _vec.assign(first, last);
+            } else {
+                _vec.clear();
+                for (; first != last; ++first)
+                    emplace_back(*first);
+            }
+        };
+        void assign(::std::initializer_list<T> ilist) {
+            assign(ilist.begin(), ilist.end());
+        };
+
+        // operator ='s
+        small_vector &operator=(const small_vector &other) {
+            if (this == &other)
+                return *this;
+            if (other.size() > capacity()) {
+                _vec.clear();
+                reserve(other.size());
+            }
+            _vec = other._vec;
+            return *this;
+        };
+        small_vector &operator=(small_vector &&other) noexcept(
+            ::std::is_nothrow_move_constructible<T>::value && ::std::is_nothrow_move_assignable<T>::value) {
+            if (this == &other)
+                return *this;
+            if (other.is_inline()) {
+                // element wise, our capacity is at least N
+                _vec.assign_elements(::std::move(other._vec));
+            } else {
+                _vec.clear();
+                release_heap();
+                _alloc = ::std::move(other._alloc);
+                rebind(other._vec._data, other._vec._end, other._vec._cap);
+                other.reset_inline();
+            }
+            return *this;
+        };
+        small_vector &operator=(::std::initializer_list<T> ilist) {
+            assign(ilist);
+            return *this;
+        };
+
+        // append's (non-standard)
+        void append(size_type count, const T &value) {
+            insert(end(), count, value);
+        }
+        template <::std::input_iterator It1> void append(It1 first, It1 last) {
+            insert(end(), first, last);
+        }
+
+        // emplace_back's
+        template <class... Args> reference emplace_back(Args &&...args) {
+            if (size() < capacity()) [[likely]] {
+                return _vec.unchecked_emplace_back(::std::forward<Args>(args)...);
+            }
+            return *reallocate(grown_capacity(size() + 1), size(), 1,
+                               [&](T *dest) { ::new ((void *)dest) T(::std::forward<Args>(args)...); });
+        };
+        template <class... Args> reference unchecked_emplace_back(Args &&...args) {
+            return _vec.unchecked_emplace_back(::std::forward<Args>(args)...);
+        };
+
+        // emplace's
+        template <class... Args> iterator emplace(const_iterator pos, Args &&...args) {
+            if (size() < capacity()) [[likely]] {
+                return _vec.emplace(pos, ::std::forward<Args>(args)...);
+            }
+            return reallocate(grown_capacity(size() + 1), pos - cbegin(), 1,
+                              [&](T *dest) { ::new ((void *)dest) T(::std::forward<Args>(args)...); });
+        };
+
+        // insert's
+        iterator insert(const_iterator pos, const T &value) {
+            return emplace(pos, value);
+        };
+        iterator insert(const_iterator pos, T &&value) {
+            return emplace(pos, ::std::move(value));
+        };
+        iterator insert(const_iterator pos, size_type count, const T &value) {
+            if (count <= capacity() - size()) [[likely]] {
+                return _vec.insert(pos, count, value);
+            }
+            return reallocate(grown_capacity(size() + count), pos - cbegin(), count, [&](T *dest) {
+                ::inline_vector::details::uninitialized_fill_n(dest, count, value);
+            });
+        };
+        template <::std::input_iterator It1> iterator insert(const_iterator pos, It1 first, It1 last) {
+            if constexpr (::std::forward_iterator<It1>) {
+                size_type count = ::std::distance(first, last);
+                if (count <= capacity() - size()) [[likely]] {
+                    return _vec.insert(pos, first, last);
+                }
+                return reallocate(grown_capacity(size() + count), pos - cbegin(), count, [&](T *dest) {
+                    ::inline_vector::details::uninitialized_copy_n(first, count, dest);
+                });
+            } else {
+                // single pass input, append then rotate into place
+                size_type insert_idx = pos - cbegin();
+                size_type old_size   = size();
+                for (; first != last; ++first)
+                    emplace_back(*first);
+                ::std::rotate(begin() + insert_idx, begin() + old_size, end());
+                return begin() + insert_idx;
+            }
+        };
+        iterator insert(const_iterator pos, ::std::initializer_list<T> ilist) {
+            return insert(pos, ilist.begin(), ilist.end());
+        };
+
+        // push_back's
+        void push_back(const T &value) {
+            emplace_back(value);
+        }
+        void push_back(T &&value) {
+            emplace_back(::std::move(value));
+        };
+
+        // pop_back's
+        void pop_back() {
+            _vec.pop_back();
+        };
+
+        // erase's
+        iterator erase(const_iterator pos) {
+            return _vec.erase(pos);
+        }
+        iterator erase(const_iterator first, const_iterator last) {
+            return _vec.erase(first, last);
+        }
+        template <class Pred> size_type erase_if(Pred pred) {
+            return _vec.erase_if(pred);
+        }
+        template <class It1> size_type remove_indices(It1 first, It1 last) {
+            return _vec.remove_indices(first, last);
+        }
+        template <class Range> size_type remove_indices(const Range &indices) {
+            return _vec.remove_indices(indices);
+        }
+        iterator unordered_erase(const_iterator pos) {
+            return _vec.unordered_erase(pos);
+        }
+        iterator unordered_erase(const_iterator first, const_iterator last) {
+            return _vec.unordered_erase(first, last);
+        }
+        template <class Pred> size_type unordered_erase_if(Pred pred) {
+            return _vec.unordered_erase_if(pred);
+        }
+
+        void swap(small_vector &other) {
+            if (this == &other)
+                return;
+            if (!is_inline() && !other.is_inline()) {
+                _vec.swap(other._vec);
+                ::std::swap(_alloc, other._alloc);
+                return;
+            }
+            small_vector tmp(::std::move(other));
+            other = ::std::move(*this);
+            *this = ::std::move(tmp);
+        }
+
+        //[]'s
+        [[nodiscard]] reference operator[](size_type pos) {
+            return _vec[pos];
+        };
+        [[nodiscard]] const_reference operator[](size_type pos) const {
+            return _vec[pos];
+        };
+
+        // resize's, grows the storage first when count doesn't fit
+        void resize(size_type count) {
+            if (count > capacity())
+                reserve(grown_capacity(count));
+            _vec.resize(count);
+        };
+        void resize(size_type count, const T &value) {
+            if (count > capacity()) {
+                insert(end(), count - size(), value); // value may live in the current buffer
+                return;
+            }
+            _vec.resize(count, value);
+        };
+        void resize_for_overwrite(size_type count) {
+            if (count > capacity())
+                reserve(grown_capacity(count));
+            _vec.resize_for_overwrite(count);
+        };
+        void truncate(size_type count) noexcept {
+            _vec.truncate(count);
+        };
+
+        void clear() noexcept {
+            _vec.clear();
+        };
+    };
+} // namespace inline_vector
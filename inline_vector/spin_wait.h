@@ -0,0 +1,37 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <cstddef>
+#include <thread>
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace inline_vector {
+    // helpers shared by the concurrent containers
+    namespace details {
+        // keeps contended atomics on their own line
+        inline constexpr ::std::size_t false_sharing_range = 64;
+
+        // spin loop hint, lets the sibling hyperthread run and saves power while waiting
+        INLINE_VECTOR_FORCEINLINE void cpu_relax() noexcept {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_ia32_pause();
+#elif defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__aarch64__) || defined(__arm__))
+            __asm__ __volatile__("yield");
+#endif
+        }
+        // spins until done() holds, yielding the core once the wait is longer than a few hundred cycles
+        template <typename Done> void spin_until(Done &&done) noexcept(noexcept(done())) {
+            for (unsigned spins = 0; !done(); spins++) {
+                if (spins < 64)
+                    ::inline_vector::details::cpu_relax();
+                else
+                    ::std::this_thread::yield();
+            }
+        }
+    }; // namespace details
+} // namespace inline_vector
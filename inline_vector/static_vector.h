@@ -0,0 +1,351 @@
+#pragma once
+#include "inline_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace inline_vector {
+    namespace details {
+        // smallest unsigned type able to count to N
+        template <::std::size_t N>
+        using smallest_size_t = ::std::conditional_t<
+            N <= UINT8_MAX, uint8_t,
+            ::std::conditional_t<N <= UINT16_MAX, uint16_t,
+                                 ::std::conditional_t<N <= UINT32_MAX, uint32_t, ::std::size_t>>>;
+    }; // namespace details
+
+    // owning fixed capacity vector, elements live inside the object itself. Everything beyond the
+    // hot accessors is forwarded to an inline_vector viewing the embedded storage, so the
+    // algorithms (and error handling) are exactly those of inline_vector with capacity() folded to N.
+    template <typename T, ::std::size_t N, typename ErrorPolicy = ::inline_vector::default_error_policy>
+    struct static_vector {
+        static_assert(N > 0, "static_vector requires a non zero capacity");
+
+        using element_type           = T;
+        using value_type             = typename ::std::remove_cv<T>::type;
+        using const_reference        = const value_type &;
+        using size_type              = ::std::size_t;
+        using difference_type        = ::std::ptrdiff_t;
+        using pointer                = element_type *;
+        using const_pointer          = const element_type *;
+        using reference              = element_type &;
+        using iterator               = pointer;
+        using const_iterator         = const_pointer;
+        using reverse_iterator       = ::std::reverse_iterator<iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+        using stored_size_type       = ::inline_vector::details::smallest_size_t<N>;
+        using view_type              = ::inline_vector::inline_vector<T, false, ErrorPolicy>;
+        using error_policy           = ErrorPolicy;
+
+      private:
+        alignas(T)::std::byte _storage[sizeof(T) * N];
+        stored_size_type      _size;
+
+        [[nodiscard]] view_type view() noexcept {
+            return view_type{data(), data() + _size, data() + N};
+        }
+        // runs fn against a view of the storage and keeps the resulting size
+        template <typename Fn> decltype(auto) apply(Fn &&fn) {
+            view_type v = view();
+            struct sync {
+                view_type        &v;
+                stored_size_type &size;
+                ~sync() {
+                    size = static_cast<stored_size_type>(v.size());
+                }
+            } on_exit{v, _size};
+            return ::std::forward<Fn>(fn)(v);
+        }
+
+      public:
+        static_vector() noexcept : _size(0){};
+        explicit static_vector(size_type count, const T &value) : _size(0) {
+            assign(count, value);
+        };
+        template <::std::input_iterator It1> static_vector(It1 first, It1 last) : _size(0) {
+            assign(first, last);
+        };
+        static_vector(::std::initializer_list<T> ilist) : _size(0) {
+            assign(ilist);
+        };
+        static_vector(const static_vector &other) noexcept(::std::is_nothrow_copy_constructible<T>::value)
+            : _size(0) {
+            ::inline_vector::details::uninitialized_copy_n(other.data(), other.size(), data());
+            _size = other._size;
+        };
+        static_vector(static_vector &&other) noexcept(::std::is_nothrow_move_constructible<T>::value)
+            : _size(0) {
+            ::inline_vector::details::uninitialized_move_n(other.data(), other.size(), data());
+            _size = other._size;
+            other.clear();
+        };
+        ~static_vector() {
+            clear();
+        };
+
+        // front
+        [[nodiscard]] reference front() {
+            assert(!empty());
+            return data()[0];
+        };
+        [[nodiscard]] const_reference front() const {
+            assert(!empty());
+            return data()[0];
+        };
+        // back's
+        [[nodiscard]] reference back() {
+            assert(!empty());
+            return data()[_size - 1];
+        };
+        [[nodiscard]] const_reference back() const {
+            assert(!empty());
+            return data()[_size - 1];
+        };
+        // data's
+        [[nodiscard]] T *data() noexcept {
+            return ::std::launder(reinterpret_cast<T *>(_storage));
+        };
+        [[nodiscard]] const T *data() const noexcept {
+            return ::std::launder(reinterpret_cast<const T *>(_storage));
+        };
+        // begin's
+        [[nodiscard]] iterator begin() noexcept {
+            return data();
+        };
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return data();
+        };
+        [[nodiscard]] const_iterator cbegin() const noexcept {
+            return data();
+        };
+        // rbegin's
+        [[nodiscard]] reverse_iterator rbegin() noexcept {
+            return reverse_iterator(end());
+        };
+        [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        };
+        [[nodiscard]] const_reverse_iterator crbegin() const noexcept {
+            return const_reverse_iterator(end());
+        };
+        // end's
+        [[nodiscard]] iterator end() noexcept {
+            return data() + _size;
+        };
+        [[nodiscard]] const_iterator end() const noexcept {
+            return data() + _size;
+        };
+        [[nodiscard]] const_iterator cend() const noexcept {
+            return data() + _size;
+        };
+        // rend's
+        [[nodiscard]] reverse_iterator rend() noexcept {
+            return reverse_iterator(begin());
+        };
+        [[nodiscard]] const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        };
+        [[nodiscard]] const_reverse_iterator crend() const noexcept {
+            return const_reverse_iterator(begin());
+        };
+        // empty's
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _size == 0;
+        };
+        // full (non standard)
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _size >= N;
+        };
+
+        // size
+        constexpr size_type size() const noexcept {
+            return _size;
+        };
+        // capacity
+        static constexpr size_type capacity() noexcept {
+            return N;
+        };
+        // max_size (constant)
+        static constexpr size_type max_size() noexcept {
+            return N;
+        };
+
+        // assign's
+        void assign(size_type count, const T &value) {
+            apply([&](view_type &v) { v.assign(count, value); });
+        };
+        template <::std::input_iterator It1> void assign(It1 first, It1 last) {
+            apply([&](view_type &v) { v.assign(first, last); });
+        };
+        void assign(::std::initializer_list<T> ilist) {
+            assign(ilist.begin(), ilist.end());
+        };
+
+        // operator ='s
+        static_vector &operator=(const static_vector &other) {
+            if (this != &other) {
+                view_type rhs = const_cast<static_vector &>(other).view();
+                apply([&](view_type &v) { v = rhs; });
+            }
+            return *this;
+        };
+        static_vector &
+        operator=(static_vector &&other) noexcept(::std::is_nothrow_move_assignable<T>::value) {
+            if (this != &other) {
+                view_type rhs = other.view();
+                apply([&](view_type &v) { v.assign_elements(::std::move(rhs)); });
+                other._size = static_cast<stored_size_type>(rhs.size());
+            }
+            return *this;
+        };
+        static_vector &operator=(::std::initializer_list<T> ilist) {
+            assign(ilist);
+            return *this;
+        };
+
+        // append's (non-standard)
+        void append(size_type count, const T &value) {
+            apply([&](view_type &v) { v.append(count, value); });
+        }
+        template <::std::input_iterator It1> void append(It1 first, It1 last) {
+            apply([&](view_type &v) { v.append(first, last); });
+        }
+
+        // emplace_back's
+        template <class... Args> reference emplace_back(Args &&...args) {
+            if (!ErrorPolicy::checked || _size < N) [[likely]] {
+                return unchecked_emplace_back(::std::forward<Args>(args)...);
+            } else { // error?
+                return apply(
+                    [&](view_type &v) -> reference { return v.emplace_back(::std::forward<Args>(args)...); });
+            }
+        };
+        template <class... Args> reference unchecked_emplace_back(Args &&...args) {
+            iterator it = end();
+            ::new ((void *)it) T(::std::forward<Args>(args)...);
+            _size += 1;
+            return *it;
+        };
+
+        // emplace's
+        template <class... Args> iterator emplace(const_iterator pos, Args &&...args) {
+            return apply([&](view_type &v) { return v.emplace(pos, ::std::forward<Args>(args)...); });
+        };
+
+        // insert's
+        iterator insert(const_iterator pos, const T &value) {
+            return emplace(pos, value);
+        };
+        iterator insert(const_iterator pos, T &&value) {
+            return emplace(pos, ::std::move(value));
+        };
+        iterator insert(const_iterator pos, size_type count, const T &value) {
+            return apply([&](view_type &v) { return v.insert(pos, count, value); });
+        };
+        template <::std::input_iterator It1> iterator insert(const_iterator pos, It1 first, It1 last) {
+            return apply([&](view_type &v) { return v.insert(pos, first, last); });
+        };
+        iterator insert(const_iterator pos, ::std::initializer_list<T> ilist) {
+            return insert(pos, ilist.begin(), ilist.end());
+        };
+
+        // push_back's
+        void push_back(const T &value) {
+            emplace_back(value);
+        }
+        void push_back(T &&value) {
+            emplace_back(::std::move(value));
+        };
+        // shove_back's (unchecked_push_back)
+        void shove_back(const T &value) {
+            unchecked_emplace_back(value);
+        }
+        void shove_back(T &&value) {
+            unchecked_emplace_back(::std::move(value));
+        }
+
+        // pop_back's
+        void pop_back() {
+            if (!ErrorPolicy::checked || _size) [[likely]] {
+                _size -= 1;
+                if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                    end()->~T(); // destroy the tailing value
+                }
+            } else {
+                apply([](view_type &v) { v.pop_back(); });
+            }
+        };
+
+        // erase's
+        iterator erase(const_iterator pos) {
+            return apply([&](view_type &v) { return v.erase(pos); });
+        }
+        iterator erase(const_iterator first, const_iterator last) {
+            return apply([&](view_type &v) { return v.erase(first, last); });
+        }
+        template <class Pred> size_type erase_if(Pred pred) {
+            return apply([&](view_type &v) { return v.erase_if(pred); });
+        }
+        template <class It1> size_type remove_indices(It1 first, It1 last) {
+            return apply([&](view_type &v) { return v.remove_indices(first, last); });
+        }
+        template <class Range> size_type remove_indices(const Range &indices) {
+            return apply([&](view_type &v) { return v.remove_indices(indices); });
+        }
+        iterator unordered_erase(const_iterator pos) {
+            return apply([&](view_type &v) { return v.unordered_erase(pos); });
+        }
+        iterator unordered_erase(const_iterator first, const_iterator last) {
+            return apply([&](view_type &v) { return v.unordered_erase(first, last); });
+        }
+        template <class Pred> size_type unordered_erase_if(Pred pred) {
+            return apply([&](view_type &v) { return v.unordered_erase_if(pred); });
+        }
+
+        // element wise, storage can't change hands
+        void swap(static_vector &other) noexcept(::std::is_nothrow_swappable<T>::value &&
+                                                 ::std::is_nothrow_move_constructible<T>::value) {
+            if (this == &other)
+                return;
+            static_vector &small  = _size < other._size ? *this : other;
+            static_vector &large  = _size < other._size ? other : *this;
+            size_type      common = small.size();
+            ::std::swap_ranges(small.begin(), small.end(), large.begin());
+            ::inline_vector::details::uninitialized_move(large.begin() + common, large.end(), small.end());
+            ::inline_vector::details::destroy(large.begin() + common, large.end());
+            small._size = large._size;
+            large._size = static_cast<stored_size_type>(common);
+        }
+
+        //[]'s
+        [[nodiscard]] reference operator[](size_type pos) {
+            assert(pos < size());
+            return data()[pos];
+        };
+        [[nodiscard]] const_reference operator[](size_type pos) const {
+            assert(pos < size());
+            return data()[pos];
+        };
+
+        // resize's
+        void resize(size_type count) {
+            apply([&](view_type &v) { v.resize(count); });
+        };
+        void resize(size_type count, const T &value) {
+            apply([&](view_type &v) { v.resize(count, value); });
+        };
+        void resize_for_overwrite(size_type count) {
+            apply([&](view_type &v) { v.resize_for_overwrite(count); });
+        };
+        void truncate(size_type count) noexcept {
+            apply([&](view_type &v) { v.truncate(count); });
+        };
+
+        void clear() noexcept {
+            if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                ::inline_vector::details::destroy(begin(), end());
+            }
+            _size = 0;
+        };
+    };
+} // namespace inline_vector
@@ -0,0 +1,266 @@
+#pragma once
+#include "inline_vector.h"
+#include "inline_work_deque.h"
+#include "simd_search.h"
+#include "spin_wait.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace inline_vector {
+    // fixed set of std::threads that run one parallel loop at a time, the calling thread takes part.
+    // A loop is a number of chunks: the caller pushes the whole range of chunks into its own
+    // inline_work_deque, whoever pops a range splits it in halves, pushes the upper half for thieves
+    // and keeps going with the lower one until a single chunk is left, idle threads steal. The
+    // deques are a fixed 64 entries (splitting keeps at most log2(chunks) of them queued per thread),
+    // the only allocation is the workers themselves at construction. Between loops the workers sleep
+    // in std::atomic::wait. A loop started from inside a chunk runs serially on that thread.
+    struct thread_pool {
+        using size_type = ::std::size_t;
+
+      private:
+        // a range of chunks [begin, end) packed as (begin << 32) | end
+        using task = ::std::uint64_t;
+
+        static constexpr size_type deque_capacity = 64;
+
+        struct job {
+            void (*invoke)(void *context, size_type chunk, unsigned self) noexcept;
+            void                   *context;
+            ::std::atomic<size_type> remaining; // chunks not yet run
+        };
+        struct alignas(::inline_vector::details::false_sharing_range) participant {
+            alignas(::std::atomic<task>) unsigned char
+                                    storage[inline_work_deque<task>::bytes_for(deque_capacity)];
+            inline_work_deque<task> deque{storage, sizeof(storage)};
+        };
+
+        ::std::unique_ptr<participant[]> _participants; // [0] is the calling thread's
+        ::std::unique_ptr<::std::thread[]> _workers;
+        unsigned                           _count = 1; // participants, workers + the caller
+        ::std::mutex                       _run_lock;  // one loop at a time
+        alignas(::inline_vector::details::false_sharing_range)::std::atomic<job *> _job{nullptr};
+        ::std::atomic<unsigned>  _busy{0};       // workers that may be looking at _job
+        ::std::atomic<size_type> _generation{0}; // bumped to wake the workers
+        ::std::atomic<bool>      _stop{false};
+
+        [[nodiscard]] static constexpr task pack(size_type begin, size_type end) noexcept {
+            return (task(begin) << 32) | task(end);
+        }
+        [[nodiscard]] static bool &inside_chunk() noexcept {
+            static thread_local bool inside = false;
+            return inside;
+        }
+
+        // runs a popped or stolen range: splits off the upper halves for thieves, runs one chunk
+        void run_task(job &j, task t, unsigned self) noexcept {
+            size_type begin = static_cast<size_type>(t >> 32);
+            size_type end   = static_cast<size_type>(t & 0xffffffffu);
+            while (end - begin > 1) {
+                size_type mid = begin + (end - begin) / 2;
+                if (!_participants[self].deque.try_push(pack(mid, end)))
+                    break; // full, run the rest here
+                end = mid;
+            }
+            inside_chunk() = true;
+            for (size_type chunk = begin; chunk != end; chunk++)
+                j.invoke(j.context, chunk, self);
+            inside_chunk() = false;
+            j.remaining.fetch_sub(end - begin, ::std::memory_order_acq_rel);
+        }
+        // takes part in j until every chunk has run
+        void work(job &j, unsigned self) noexcept {
+            inline_work_deque<task> &own = _participants[self].deque;
+            for (unsigned idle = 0; j.remaining.load(::std::memory_order_acquire) != 0;) {
+                task t;
+                bool found = own.try_pop(t);
+                for (unsigned k = 1; !found && k < _count; k++)
+                    found = _participants[(self + k) % _count].deque.try_steal(t);
+                if (found) {
+                    run_task(j, t, self);
+                    idle = 0;
+                } else if (idle++ < 64) {
+                    ::inline_vector::details::cpu_relax();
+                } else {
+                    ::std::this_thread::yield();
+                }
+            }
+        }
+        void worker_main(unsigned self) noexcept {
+            size_type seen = 0;
+            for (;;) {
+                _generation.wait(seen, ::std::memory_order_acquire);
+                seen = _generation.load(::std::memory_order_acquire);
+                if (_stop.load(::std::memory_order_acquire))
+                    return;
+                // announce before looking at _job, run() clears _job before waiting for _busy to drop
+                _busy.fetch_add(1, ::std::memory_order_seq_cst);
+                if (job *j = _job.load(::std::memory_order_seq_cst))
+                    work(*j, self);
+                _busy.fetch_sub(1, ::std::memory_order_release);
+            }
+        }
+
+      public:
+        // threads participants in total, the calling thread is one of them (1 runs everything inline)
+        explicit thread_pool(unsigned threads = ::std::thread::hardware_concurrency())
+            : _participants(new participant[(::std::max)(threads, 1u)]), _count((::std::max)(threads, 1u)) {
+            _workers.reset(new ::std::thread[_count - 1]);
+            for (unsigned i = 1; i < _count; i++)
+                _workers[i - 1] = ::std::thread([this, i] { worker_main(i); });
+        }
+        ~thread_pool() {
+            _stop.store(true, ::std::memory_order_release);
+            _generation.fetch_add(1, ::std::memory_order_release);
+            _generation.notify_all();
+            for (unsigned i = 0; i + 1 < _count; i++)
+                _workers[i].join();
+        }
+        thread_pool(const thread_pool &)            = delete;
+        thread_pool &operator=(const thread_pool &) = delete;
+
+        // threads taking part in a loop, the caller included
+        [[nodiscard]] unsigned concurrency() const noexcept {
+            return _count;
+        }
+
+        // run, calls body(chunk, participant) once for every chunk in [0, chunks) and returns when all
+        // have run. participant < concurrency() is unique among the threads running at the same time.
+        // body must not throw (as with the parallel standard algorithms an exception terminates).
+        template <typename Body> void run(size_type chunks, Body &&body) {
+            assert(chunks <= 0xffffffffu && "thread_pool::run takes at most 2^32 - 1 chunks");
+            if (chunks == 0)
+                return;
+            if (chunks == 1 || _count == 1 || inside_chunk()) {
+                for (size_type chunk = 0; chunk < chunks; chunk++)
+                    [&]() noexcept { body(chunk, 0u); }();
+                return;
+            }
+            using body_type = ::std::remove_reference_t<Body>;
+            job j{[](void *context, size_type chunk, unsigned self) noexcept {
+                      (*static_cast<body_type *>(context))(chunk, self);
+                  },
+                  const_cast<void *>(static_cast<const void *>(::std::addressof(body))), chunks};
+
+            ::std::lock_guard<::std::mutex> hold(_run_lock);
+            _participants[0].deque.try_push(pack(0, chunks));
+            _job.store(&j, ::std::memory_order_seq_cst);
+            _generation.fetch_add(1, ::std::memory_order_release);
+            _generation.notify_all();
+            work(j, 0);
+            // j lives on this stack, wait for the workers still holding on to it
+            _job.store(nullptr, ::std::memory_order_seq_cst);
+            ::inline_vector::details::spin_until(
+                [&]() noexcept { return _busy.load(::std::memory_order_seq_cst) == 0; });
+        }
+    };
+
+    namespace details {
+        // cuts [0, n) elements of T into chunks that start on a cache line (measured from data, the
+        // first chunk takes the elements up to the first line boundary) so no two threads write to
+        // the same line, about 8 chunks per thread and at least grain elements each
+        template <typename T> struct line_chunks {
+            using size_type = ::std::size_t;
+
+            size_type n     = 0;
+            size_type first = 0; // end of chunk 0
+            size_type step  = 0; // elements in every later chunk but the last
+            size_type count = 0;
+
+            line_chunks(const T *data, size_type size, unsigned threads, size_type grain) noexcept : n(size) {
+                constexpr size_type line = ::inline_vector::details::false_sharing_range;
+                size_type per_line = sizeof(T) < line && line % sizeof(T) == 0 ? line / sizeof(T) : 1;
+                size_type target   = (::std::max)({grain, size / (size_type(threads) * 8), per_line});
+                step               = (target + per_line - 1) / per_line * per_line;
+                size_type head     = 0;
+                if (per_line > 1 && reinterpret_cast<::std::uintptr_t>(data) % sizeof(T) == 0)
+                    head = ((line - reinterpret_cast<::std::uintptr_t>(data) % line) % line) / sizeof(T);
+                first = (::std::min)(n, head ? head : step);
+                count = n == 0 ? 0 : 1 + (n - first + step - 1) / step;
+            }
+            [[nodiscard]] size_type begin(size_type chunk) const noexcept {
+                return chunk == 0 ? 0 : (::std::min)(n, first + (chunk - 1) * step);
+            }
+            [[nodiscard]] size_type end(size_type chunk) const noexcept {
+                return (::std::min)(n, first + chunk * step);
+            }
+        };
+    }; // namespace details
+
+    // parallel_for_each, f(element) for every element of v, in no particular order. grain is the
+    // smallest number of elements worth handing to another thread.
+    template <::inline_vector::simd::contiguous_vector Vec, typename F>
+    void parallel_for_each(thread_pool &pool, Vec &v, F f, ::std::size_t grain = 0) {
+        auto                                                    *data = v.data();
+        ::inline_vector::details::line_chunks<::std::remove_pointer_t<decltype(data)>> chunks(
+            data, v.size(), pool.concurrency(), grain);
+        pool.run(chunks.count, [&](::std::size_t chunk, unsigned) {
+            for (auto *it = data + chunks.begin(chunk), *last = data + chunks.end(chunk); it != last; ++it)
+                f(*it);
+        });
+    }
+
+    // parallel_transform, appends f(element) for every element of in to out, constructed in place in
+    // out's spare capacity (the chunks are cut along out's cache lines). All or nothing, returns the
+    // first new element of out or nullptr when out has no room for in.size() more.
+    template <::inline_vector::simd::contiguous_vector Vec, typename Out, typename F>
+    typename Out::pointer parallel_transform(thread_pool &pool, const Vec &in, Out &out, F f,
+                                             ::std::size_t grain = 0) {
+        using U         = typename Out::value_type;
+        const auto  *src  = in.data();
+        ::std::size_t n   = in.size();
+        if (static_cast<::std::size_t>(out._cap - out._end) < n) [[unlikely]] {
+            Out::error_policy::on_error(::std::errc::not_enough_memory,
+                                        "parallel_transform output cannot allocate to insert elements");
+            return nullptr;
+        }
+        typename Out::pointer dest = out._end;
+        ::inline_vector::details::line_chunks<U> chunks(dest, n, pool.concurrency(), grain);
+        pool.run(chunks.count, [&](::std::size_t chunk, unsigned) {
+            const auto *it = src + chunks.begin(chunk), *last = src + chunks.end(chunk);
+            for (U *to = dest + chunks.begin(chunk); it != last; ++it, ++to)
+                ::new ((void *)to) U(f(*it));
+        });
+        out._end = dest + n;
+        return dest;
+    }
+
+    // parallel_reduce, op folded over init and every element of v, in no particular order or
+    // grouping, so op has to be associative and commutative (as for std::reduce). Each thread folds
+    // its chunks into its own partial result, one allocation holds them.
+    template <::inline_vector::simd::contiguous_vector Vec, typename R, typename Op>
+    [[nodiscard]] R parallel_reduce(thread_pool &pool, const Vec &v, R init, Op op, ::std::size_t grain = 0) {
+        struct alignas(::inline_vector::details::false_sharing_range) partial {
+            ::std::optional<R> value;
+        };
+        const auto *data = v.data();
+        ::inline_vector::details::line_chunks<::std::remove_cv_t<::std::remove_pointer_t<decltype(data)>>>
+            chunks(data, v.size(), pool.concurrency(), grain);
+        if (chunks.count == 0)
+            return init;
+        ::std::unique_ptr<partial[]> partials(new partial[pool.concurrency()]);
+        pool.run(chunks.count, [&](::std::size_t chunk, unsigned participant) {
+            const auto *it = data + chunks.begin(chunk), *last = data + chunks.end(chunk);
+            R           acc(*it++);
+            for (; it != last; ++it)
+                acc = op(::std::move(acc), *it);
+            ::std::optional<R> &sum = partials[participant].value;
+            if (sum)
+                *sum = op(::std::move(*sum), ::std::move(acc));
+            else
+                sum.emplace(::std::move(acc));
+        });
+        for (unsigned p = 0; p < pool.concurrency(); p++)
+            if (partials[p].value)
+                init = op(::std::move(init), ::std::move(*partials[p].value));
+        return init;
+    }
+} // namespace inline_vector